@@ -39,6 +39,15 @@ core::core()
     _load_from_checkpoint=false;
     _do_checkpoint=false;
     _metdata= nullptr;
+    _use_task_graph=false;
+    _task_graph_block_size=2048;
+    _load_balance=false;
+    _load_balance_block_size=256;
+    _async_output=false;
+    _async_output_queue=2;
+    _spline_cache_bytes=size_t(512)*1024*1024;
+    _profile_trace_blocks=false;
+    _mesh_cache_hash=0;
 }
 
 core::~core()
@@ -102,6 +111,10 @@ void core::config_options( pt::ptree &value)
     {
         _interpolation_method = interp_alg::nearest_sta;
     }
+    else if (ia == "bilinear")
+    {
+        _interpolation_method = interp_alg::bilinear_grid;
+    }
     else
     {
         LOG_WARNING << "Unknown interpolant selected, defaulting to spline";
@@ -140,6 +153,39 @@ void core::config_options( pt::ptree &value)
 
     }
 
+    std::string scheduler = value.get("scheduler","chunked");
+    if(scheduler == "task_graph")
+    {
+        _use_task_graph = true;
+    }
+    else if(scheduler != "chunked")
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown scheduler " + scheduler + ". Options are chunked or task_graph."));
+    }
+    _task_graph_block_size = value.get("scheduler_block_size", _task_graph_block_size);
+
+    _metdata->enable_prefetch(value.get("prefetch_forcing", false));
+
+    _load_balance = value.get("load_balance", false);
+    _load_balance_block_size = value.get("load_balance_block_size", _load_balance_block_size);
+
+    _async_output = value.get("async_output", false);
+    _async_output_queue = value.get("async_output_queue", _async_output_queue);
+    if(_async_output && _async_output_queue == 0)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("async_output_queue must be at least 1."));
+    }
+
+    _spline_cache_bytes = value.get("spline_cache_mb", _spline_cache_bytes / (1024 * 1024)) * 1024 * 1024;
+
+    if(value.get("profile", false))
+    {
+        bool trace = value.get("profile_trace", false);
+        LOG_DEBUG << "Profiling enabled" << (trace ? " with trace output" : "");
+        profiler::get().enable(trace, value.get("profile_trace_max_events", size_t(1000000)));
+        _profile_trace_blocks = trace && value.get("profile_trace_blocks", false);
+    }
+
     auto notify_sh = value.get_optional<std::string>("notification_script");
     if(notify_sh)
     {
@@ -154,9 +200,19 @@ void core::config_options( pt::ptree &value)
         BOOST_THROW_EXCEPTION(config_error() << errstr_info("Cannot have both station_search_radius and station_N_nearest set."));
     }
 
-    if(radius)
+    if(ia == "bilinear")
+    {
+        // the face station lists are the enclosing NetCDF grid cells, see populate_face_station_lists
+        if(radius || N)
+        {
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("station_search_radius and station_N_nearest cannot be used with the bilinear interpolant."));
+        }
+        _station_search = "bilinear";
+    }
+    else if(radius)
     {
         _metdata->get_stations = boost::bind( &metdata::get_stations_in_radius,_metdata,_1,_2, *radius);
+        _station_search = "radius " + std::to_string(*radius);
     }
     else
     {
@@ -184,6 +240,7 @@ void core::config_options( pt::ptree &value)
         }
 
         _metdata->get_stations = boost::bind( &metdata::nearest_station,_metdata,_1,_2, n);
+        _station_search = "nearest " + std::to_string(n);
     }
 
 
@@ -263,6 +320,10 @@ void core::config_modules(pt::ptree &value, const pt::ptree &config, std::vector
         //assign the internal global param pointer to our global
         module->global_param = _global;
 
+        // modules that precompute from the terrain, e.g., fast_shadow's horizons, need to know it will change
+        if(module_name == "deform_mesh")
+            _global->_is_static_terrain = false;
+
         //get the parameters that this module will provide
         // we need this now before the mesh call as in the mesh call we will build the static mph hashtable for all parameters
         for(auto& p: *(module->provides_parameter())) {
@@ -472,7 +533,10 @@ void core::determine_startend_ts_forcing()
     if(_load_from_checkpoint)
     {
         size_t t = 0;
-        _in_savestate.get_ncfile().getAtt("restart_time_sec").getValues(&t);
+        {
+            std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+            _in_savestate.get_ncfile().getAtt("restart_time_sec").getValues(&t);
+        }
         _start_ts = new boost::posix_time::ptime(boost::posix_time::from_time_t(t));
 
         LOG_WARNING << "Loading from checkpoint. Overriding start time to match. New start time = " << *_start_ts;
@@ -563,6 +627,32 @@ void core::config_meshes( pt::ptree &value)
 
     _find_and_insert_subjson(value);
 
+    auto reorder = value.get("reorder", "none");
+    _mesh->set_reorder_curve(sfc::from_string(reorder));
+    LOG_DEBUG << "Mesh face reordering: " << reorder;
+
+    auto partition = value.get("partition", "block");
+    _mesh->set_partition_method(partitioner::from_string(partition));
+    LOG_DEBUG << "Mesh partitioning: " << partition;
+
+    auto partition_weight = value.get_optional<std::string>("partition_weight");
+    if(partition_weight)
+    {
+        _mesh->set_partition_weight(*partition_weight);
+        LOG_DEBUG << "Weighting the mesh partition by parameter " << *partition_weight;
+    }
+
+    if(value.get("distributed_load", false))
+    {
+        // the reordering and graph partitions need the whole mesh, which is what the distributed load avoids reading
+        if(reorder != "none" || partition != "block")
+        {
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("distributed_load requires reorder=none and partition=block."));
+        }
+        _mesh->set_distributed_load(true);
+        LOG_DEBUG << "Each process will only read its own faces from the hdf5 mesh";
+    }
+
     std::string mesh_path = value.get<std::string>("mesh");
     LOG_DEBUG << "Found mesh:" << mesh_path;
 
@@ -632,13 +722,60 @@ void core::config_meshes( pt::ptree &value)
 
     _provided_parameters = _mesh->parameters();
 
+    // A cache of the fully initialized mesh from an earlier run is used in place of the load if it was built from the
+    // same files and options. It holds the whole mesh, so it is only used by a single process.
+    auto cache = value.get_optional<std::string>("cache");
+    bool cache_hit = false;
+    bool cache_is_geographic = false;
+    if(cache)
+    {
+        bool single_process = !value.get("distributed_load", false);
+#ifdef USE_MPI
+        single_process = single_process && _comm_world.size() == 1;
+#endif
+        if(single_process)
+        {
+            PROFILE_SCOPE("mesh_cache_hash");
+
+            _mesh_cache_path = (cwd_dir / *cache).string();
+
+            std::string settings = reorder + ";" + partition + ";" + partition_weight.get_value_or("");
+            for(auto& p : _provided_parameters)
+                settings += ";" + p;
+
+            std::vector<std::string> inputs{mesh_path};
+            inputs.insert(inputs.end(), param_file_paths.begin(), param_file_paths.end());
+            inputs.insert(inputs.end(), initial_condition_file_paths.begin(), initial_condition_file_paths.end());
+            _mesh_cache_hash = mesh_cache::hash_files(inputs, mesh_cache::hash_string(settings));
+
+            // only the header is checked here, the mesh is loaded from it once the distance functions are set up
+            mesh_cache::reader header;
+            cache_hit = header.open(_mesh_cache_path, _mesh_cache_hash);
+            if(cache_hit)
+            {
+                cache_is_geographic = (header.flags() & mesh_cache::flag_geographic) != 0;
+                LOG_DEBUG << "Using the mesh cache " << _mesh_cache_path;
+            }
+            else
+                LOG_DEBUG << "The mesh cache " << _mesh_cache_path << " will be rebuilt";
+        }
+        else
+        {
+            LOG_WARNING << "The mesh cache is only used by single process runs and will be ignored";
+        }
+    }
+
     bool is_geographic = false;
 
     pt::ptree mesh; // holds the json mesh if we end up using it
 
     // Before we read the mesh, we need to know if we are geographic or projected so we can hook up all the distance functions
     // correctly. So for either json or hdf5 we check, hook up the functions, then proceed to the main load which can assume the functions are available
-    if(mesh_file_extension == ".h5")
+    if(cache_hit)
+    {
+        is_geographic = cache_is_geographic;
+    }
+    else if(mesh_file_extension == ".h5")
     {
         hsize_t geographic_dims = 1;
         H5::DataSpace dataspace(1, &geographic_dims);
@@ -672,7 +809,14 @@ void core::config_meshes( pt::ptree &value)
     ////////////////////////////////////////////////////////////
     // Actually read the mesh, parameter and ic data here
     ////////////////////////////////////////////////////////////
-    if(mesh_file_extension == ".h5")
+    if(cache_hit)
+    {
+        if(!_mesh->from_cache(_mesh_cache_path, _mesh_cache_hash))
+        {
+            BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Unable to load the mesh cache " + _mesh_cache_path));
+        }
+    }
+    else if(mesh_file_extension == ".h5")
     {
       _mesh->from_hdf5(mesh_path, param_file_paths, initial_condition_file_paths);
     }
@@ -723,6 +867,11 @@ void core::config_meshes( pt::ptree &value)
 
     }
 
+    if(!_mesh_cache_path.empty() && !cache_hit)
+    {
+        _mesh->write_cache(_mesh_cache_path, _mesh_cache_hash);
+    }
+
 
 
 
@@ -1363,6 +1512,9 @@ void core::init(int argc, char **argv)
     populate_face_station_lists();
     populate_distributed_station_lists();
 
+    // the face station lists are fixed from here, so the static interpolation weights can be built
+    _mesh->build_station_weights(_metdata->stations(), _interpolation_method);
+
 
     boost::filesystem::path full_path(boost::filesystem::current_path());
 
@@ -1922,6 +2074,15 @@ void core::_determine_module_dep()
     ierr = std::remove("modules.dot.tmp"); CHK_SYSTEM_ERR(ierr);
     ierr = std::remove("filter.gvpr"); CHK_SYSTEM_ERR(ierr);
 
+    //keep the edges for the task graph scheduler. Vertex index == position in _modules prior to the sort below
+    _module_edges.clear();
+    boost::graph_traits<Graph>::edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end) = boost::edges(g); ei != ei_end; ++ei)
+    {
+        _module_edges.push_back(std::make_pair(_modules.at(boost::source(*ei, g)).first->ID,
+                                               _modules.at(boost::target(*ei, g)).first->ID));
+    }
+
     std::stringstream ss;
     size_t order = 0;
     for (std::deque<int>::const_iterator i = topo_order.begin(); i != topo_order.end(); ++i)
@@ -2017,6 +2178,39 @@ void core::_schedule_modules()
         }
         chunks++;
     }
+
+    if(_load_balance)
+    {
+        _chunk_balancers.resize(_chunked_modules.size());
+        for (size_t i = 0; i < _chunked_modules.size(); ++i)
+        {
+            if (_chunked_modules[i].at(0)->parallel_type() == module_base::parallel::data)
+                _chunk_balancers[i].init(_mesh->size_faces(), _load_balance_block_size, omp_get_max_threads());
+        }
+    }
+
+    if(_use_task_graph)
+    {
+        // point mode only runs one face, and domain modules may communicate via MPI which
+        // requires all ranks to call them in the same order from the main thread
+        bool use_mpi = false;
+#ifdef USE_MPI
+        use_mpi = true;
+#endif
+        if(point_mode.enable || use_mpi)
+        {
+            LOG_WARNING << "Task graph scheduler is not supported in point mode or with MPI, using chunked scheduler";
+            _use_task_graph = false;
+            return;
+        }
+
+        std::vector<module> modules;
+        for (auto &itr : _modules)
+        {
+            modules.push_back(itr.first);
+        }
+        _task_graph.build(modules, _module_edges, _mesh, _task_graph_block_size, _profile_trace_blocks);
+    }
 }
 
 void core::run()
@@ -2036,8 +2230,31 @@ void core::run()
     // We can do this _once_ without incrementing the internal iterators
     _metdata->next();
 
+    if(_async_output &&
+       std::any_of(_outputs.begin(), _outputs.end(),
+                   [](const output_info& o){ return o.type == output_info::output_type::mesh; }))
+    {
+        LOG_DEBUG << "Mesh output is written in the background with a queue of " << _async_output_queue << " timesteps";
+        _output_writer.start(_async_output_queue);
+    }
+
     LOG_DEBUG << "Starting model run";
 
+    // profiler regions for each module, indexed by IDnum
+    std::vector<size_t> module_region(_modules.size());
+    for (auto &itr : _modules)
+    {
+        module_region.at(itr.first->IDnum) = profiler::get().region("module:" + itr.first->ID);
+    }
+    // and for each chunk, indexed as _chunked_modules
+    std::vector<size_t> chunk_region(_chunked_modules.size());
+    for (size_t i = 0; i < _chunked_modules.size(); i++)
+    {
+        chunk_region.at(i) = profiler::get().region("chunk:" + std::to_string(i));
+    }
+    size_t timestep_region = profiler::get().region("timestep");
+    size_t checkpoint_region = profiler::get().region("checkpoint");
+
     c.tic();
 
     double meantime = 0;
@@ -2058,41 +2275,65 @@ void core::run()
             ss << _global->posix_time();
 
             c.tic();
+            profile_scope timestep_scope(timestep_region);
             size_t chunks = 0;
             try
             {
-                for (auto &itr : _chunked_modules)
+                if(_use_task_graph)
                 {
-
-                    if (itr.at(0)->parallel_type() == module_base::parallel::data)
+                    _task_graph.run(_mesh);
+                }
+                else
+                {
+                    for (auto &itr : _chunked_modules)
                     {
+                        profile_scope chunk_scope(chunk_region[chunks]);
 
-                        #pragma omp parallel for
-                        for (size_t i = 0; i < _mesh->size_faces(); i++)
+                        if (itr.at(0)->parallel_type() == module_base::parallel::data)
                         {
-                            auto face = _mesh->face(i);
-                            if (point_mode.enable && face->_debug_name != _outputs[0].name)
-                                continue;
-
-                             //module calls
-                             for (auto &jtr : itr)
-                             {
-                                 jtr->run(face);
-                             }
-                        }
-
+                            auto run_face = [&](size_t i)
+                            {
+                                auto face = _mesh->face(i);
+                                if (point_mode.enable && face->_debug_name != _outputs[0].name)
+                                    return;
+
+                                 //module calls
+                                 for (auto &jtr : itr)
+                                 {
+                                     // too fine grained for the trace, summary only
+                                     profile_scope p(module_region[jtr->IDnum], false);
+                                     jtr->run(face);
+                                 }
+                            };
+
+                            if (_load_balance)
+                            {
+                                auto& lb = _chunk_balancers.at(chunks);
+                                lb.run(run_face);
+                                LOG_VERBOSE << "Chunk " << chunks << " thread imbalance (max/mean) " << lb.last_imbalance();
+                            }
+                            else
+                            {
+                                #pragma omp parallel for
+                                for (size_t i = 0; i < _mesh->size_faces(); i++)
+                                {
+                                    run_face(i);
+                                }
+                            }
 
-                    } else
-                    {
-                        //module calls for domain parallel
-                        for (auto &jtr : itr)
+                        } else
                         {
-                          jtr->run(_mesh);
+                            //module calls for domain parallel
+                            for (auto &jtr : itr)
+                            {
+                              profile_scope p(module_region[jtr->IDnum]);
+                              jtr->run(_mesh);
+                            }
                         }
-                    }
 
-                    chunks++;
+                        chunks++;
 
+                    }
                 }
             }
             catch (exception_base &e)
@@ -2106,10 +2347,10 @@ void core::run()
 
             }
 
-            //check that we actually need a mesh output.
+            //check that we actually need a mesh output this timestep.
             for (auto &itr : _outputs)
             {
-                if(itr.type == output_info::output_type::mesh)
+                if(itr.type == output_info::output_type::mesh && current_ts % itr.frequency == 0)
                 {
                     std::vector<std::string> output;
                     output.assign(itr.variables.begin(),itr.variables.end()); //convert to list to match internal lists
@@ -2123,7 +2364,11 @@ void core::run()
             if(_do_checkpoint && (current_ts % _checkpoint_feq ==0) )
             {
                 LOG_DEBUG << "Checkpointing...";
+                profile_scope p(checkpoint_region);
                 c.tic();
+
+                // don't write the checkpoint while the next timestep's forcing is still being read
+                _metdata->wait_prefetch();
                 for (auto &itr : _chunked_modules)
                 {
                     //module calls
@@ -2139,8 +2384,11 @@ void core::run()
                 //also write it out in seconds because netcdf is struggling with the string
                 unsigned long long int ts_sec = _global->posix_time_int()+_global->_dt;
 
-                _savestate.get_ncfile().putAtt("restart_time",timestr.str());
-                _savestate.get_ncfile().putAtt("restart_time_sec", netCDF::ncUint64,ts_sec);
+                {
+                    std::lock_guard<std::recursive_mutex> lock(netcdf::library_mutex());
+                    _savestate.get_ncfile().putAtt("restart_time",timestr.str());
+                    _savestate.get_ncfile().putAtt("restart_time_sec", netCDF::ncUint64,ts_sec);
+                }
 
                 LOG_DEBUG << "Done checkpoint [ " << c.toc<s>() << "s]";
             }
@@ -2151,6 +2399,14 @@ void core::run()
                 {
                     if(current_ts % itr.frequency == 0)
                     {
+                        // With the background writer, copy the vtk data here where the copy can use all the threads.
+                        // The file is then written from the snapshot while the model continues.
+                        vtkSmartPointer<vtkUnstructuredGrid> snapshot = nullptr;
+                        if(_output_writer.running())
+                        {
+                            snapshot = _mesh->vtk_snapshot();
+                        }
+                        ompException oe;
 
                         #pragma omp parallel
                         {
@@ -2190,16 +2446,32 @@ void core::run()
                                             //to make it a relative path in the xml file.
 
 #ifdef USE_MPI
-                                            _mesh->write_vtu(base_name + "_"+std::to_string(_comm_world.rank() )+ ".vtu");
+                                            std::string fname = base_name + "_"+std::to_string(_comm_world.rank() )+ ".vtu";
 #else
-                                            _mesh->write_vtu(base_name + "_"+std::to_string(rank)+ ".vtu");
+                                            std::string fname = base_name + "_"+std::to_string(rank)+ ".vtu";
 #endif
+                                            if(snapshot)
+                                            {
+                                                // blocks if the writer is too far behind
+                                                oe.Run([&]
+                                                       {
+                                                           _output_writer.submit([snapshot, fname]
+                                                                                 {
+                                                                                     triangulation::write_vtu(snapshot, fname);
+                                                                                 });
+                                                       });
+                                            }
+                                            else
+                                            {
+                                                _mesh->write_vtu(fname);
+                                            }
 
                                         }
                                     }
                                 }
                             }
                         }
+                        oe.Rethrow();
                     }
                 }
             }
@@ -2219,6 +2491,10 @@ void core::run()
                 }
             }
 
+            // the shared spline factorizations are kept between timesteps as the stations rarely change. If nan stations
+            // have produced many combinations, the ones unused the longest are dropped to stay within the budget
+            thin_plate_spline::trim_shared_factorizations(_spline_cache_bytes);
+
             if(!_metdata->next())
                 done = true;
 
@@ -2252,9 +2528,40 @@ void core::run()
 
 
         }
+        if(_output_writer.running())
+        {
+            LOG_DEBUG << "Waiting for background output to finish";
+            _output_writer.stop();
+            LOG_DEBUG << "Output writer stalled the model " << _output_writer.stalls() << " times for "
+                      << _output_writer.stall_time() << "s";
+        }
+
         double elapsed = c.toc<s>();
         LOG_DEBUG << "Total runtime was " << elapsed << "s";
 
+    if(_load_balance)
+    {
+        for (size_t i = 0; i < _chunked_modules.size(); ++i)
+        {
+            if (_chunked_modules[i].at(0)->parallel_type() == module_base::parallel::data)
+            {
+                LOG_DEBUG << "Chunk " << i << " thread imbalance (max/mean): mean " << _chunk_balancers[i].mean_imbalance()
+                          << ", worst " << _chunk_balancers[i].max_imbalance();
+            }
+        }
+    }
+
+    int rank = 0;
+#ifdef USE_MPI
+    rank = _comm_world.rank();
+#endif
+    profiler::get().write(o_path.string(), rank);
+    if(profiler::get().dropped_events() > 0)
+    {
+        LOG_WARNING << "The profile trace reached profile_trace_max_events, " << profiler::get().dropped_events()
+                    << " events were not written";
+    }
+
 
 
     std::string base_name="";
@@ -2310,13 +2617,64 @@ void core::populate_face_station_lists()
 
     LOG_DEBUG << "Populating each face's station list";
 
+    if(_interpolation_method == interp_alg::bilinear_grid && !_use_netcdf)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("The bilinear interpolant requires NetCDF forcing."));
+    }
+
+    // The station lists only depend on the mesh, the station locations and how they are searched, so they are cached
+    // alongside the mesh
+    std::string cache_path;
+    uint64_t cache_hash = 0;
+    std::unordered_map<station*, uint32_t> station_index;
+    for (size_t i = 0; i < _metdata->nstations(); i++)
+        station_index[_metdata->at(i).get()] = i;
+
+    if(!_mesh_cache_path.empty())
+    {
+        cache_path = _mesh_cache_path + ".stations";
+        cache_hash = mesh_cache::hash_string(_station_search, _mesh_cache_hash);
+        for (size_t i = 0; i < _metdata->nstations(); i++)
+        {
+            auto s = _metdata->at(i);
+            cache_hash = mesh_cache::hash_string(s->ID() + " " + std::to_string(s->x()) + " " + std::to_string(s->y()), cache_hash);
+        }
+
+        mesh_cache::reader cache;
+        if(cache.open(cache_path, cache_hash))
+        {
+            LOG_DEBUG << "Using the cached station lists " << cache_path;
+
+            size_t n;
+            const uint32_t* offsets = cache.read_array<uint32_t>(n);
+            const uint32_t* indices = cache.read_array<uint32_t>(n);
+            const uint32_t* nearest = cache.read_array<uint32_t>(n);
+
+            if(n == _mesh->size_faces())
+            {
+                for (size_t i = 0; i < _mesh->size_faces(); i++)
+                {
+                    auto f = _mesh->face(i);
+                    for (uint32_t j = offsets[i]; j < offsets[i + 1]; j++)
+                        f->stations().push_back(_metdata->at(indices[j]));
+
+                    f->nearest_station() = _metdata->at(nearest[i]);
+                }
+                return;
+            }
+        }
+    }
+
     for (size_t i = 0; i < _mesh->size_faces(); i++)
     {
         auto f = _mesh->face(i);
 
         if ( f->stations().size() == 0 )
         {
-            auto stations = _metdata->get_stations(f->get_x(), f->get_y());
+            // gridded forcing is interpolated from the corners of the enclosing grid cell, found in grid index space
+            auto stations = _interpolation_method == interp_alg::bilinear_grid ?
+                            _metdata->grid_cell(f->get_x(), f->get_y()) :
+                            _metdata->get_stations(f->get_x(), f->get_y());
             f->stations().insert(std::end(f->stations()), std::begin(stations), std::end(stations));
 
             f->nearest_station() = _metdata->nearest_station(f->get_x(), f->get_y()).at(0);
@@ -2325,6 +2683,33 @@ void core::populate_face_station_lists()
         {
             CHM_THROW_EXCEPTION(mesh_error,"Face station list already populated.");
         }
+
+        // Keep the stations in the metdata order so that faces with the same stations present them identically to the
+        // interpolants, which lets them share the spline factorizations
+        std::sort(f->stations().begin(), f->stations().end(),
+                  [&](const std::shared_ptr<station>& a, const std::shared_ptr<station>& b)
+                  {
+                      return station_index.at(a.get()) < station_index.at(b.get());
+                  });
+    }
+
+    if(!cache_path.empty())
+    {
+        std::vector<uint32_t> offsets{0}, indices, nearest;
+        for (size_t i = 0; i < _mesh->size_faces(); i++)
+        {
+            auto f = _mesh->face(i);
+            for (auto& s : f->stations())
+                indices.push_back(station_index.at(s.get()));
+            offsets.push_back(indices.size());
+            nearest.push_back(station_index.at(f->nearest_station().get()));
+        }
+
+        mesh_cache::writer cache(cache_path, cache_hash);
+        cache.write_array(offsets);
+        cache.write_array(indices);
+        cache.write_array(nearest);
+        cache.close();
     }
 
 }
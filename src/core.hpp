@@ -41,6 +41,7 @@
 #include <set>
 #include <chrono>
 #include <map>
+#include <unordered_map>
 #include <stdio.h>
 #include <cstdlib>
 #include <chrono>
@@ -89,6 +90,10 @@ namespace po = boost::program_options;
 #include "timeseries/netcdf.hpp"
 #include "gsl/gsl_errno.h"
 #include "metdata.hpp"
+#include "task_graph.hpp"
+#include "load_balancer.hpp"
+#include "output_writer.hpp"
+#include "mesh_cache.hpp"
 
 #ifdef USE_MPI
 #include <boost/mpi.hpp>
@@ -269,6 +274,35 @@ protected:
     //pair as we also need to store the make order
     std::vector< std::pair<module,size_t> > _modules;
     std::vector< std::vector < module> > _chunked_modules;
+
+    //module dependency edges (upstream ID, downstream ID) from _determine_module_dep
+    std::vector< std::pair<std::string,std::string> > _module_edges;
+
+    //if enabled, modules are run via a task graph instead of _chunked_modules
+    bool _use_task_graph;
+    size_t _task_graph_block_size;
+    task_graph _task_graph;
+
+    //cost-aware partitioning of the data parallel chunks, one per entry in _chunked_modules
+    bool _load_balance;
+    size_t _load_balance_block_size;
+    std::vector<load_balancer> _chunk_balancers;
+
+    //if enabled, mesh output is written from a snapshot by a background thread
+    bool _async_output;
+    size_t _async_output_queue;
+    output_writer _output_writer;
+
+    //memory budget, in bytes, for the thin plate spline factorizations shared between timesteps
+    size_t _spline_cache_bytes;
+
+    //emit a profiler trace event for every task graph block rather than only the summary
+    bool _profile_trace_blocks;
+
+    //if set, the initialized mesh and the face station lists are cached here and reused while the inputs are unchanged
+    std::string _mesh_cache_path;
+    uint64_t _mesh_cache_hash;
+    std::string _station_search; // how the face station lists are built, part of the station list cache key
     std::vector< std::pair<std::string,std::string> > _overrides;
     boost::shared_ptr<global> _global;
 
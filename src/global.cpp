@@ -28,6 +28,7 @@ global::global()
     first_time_step = true;
     _utc_offset = 0;
     _is_point_mode = false;
+    _is_static_terrain = true;
     timestep_counter=0;
 }
 
@@ -80,3 +81,8 @@ bool  global::is_point_mode()
 {
     return _is_point_mode;
 }
+
+bool global::is_static_terrain()
+{
+    return _is_static_terrain;
+}
@@ -63,12 +63,16 @@ private:
     int _dt; //seconds
     bool _is_geographic;
     bool _is_point_mode;
+    bool _is_static_terrain;
 
 
 public:
 
     bool is_point_mode();
 
+    // false if a module, e.g., deform_mesh, changes the terrain during the run
+    bool is_static_terrain();
+
     // UTC offset
     int _utc_offset;
     bool is_geographic();
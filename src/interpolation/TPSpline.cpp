@@ -23,98 +23,254 @@
 
 
 #include "TPSpline.hpp"
+#include "utility/wyhash.h"
+#include "math/expint.hpp"
 
-double thin_plate_spline::operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point)
+#include <algorithm>
+#include <tuple>
+
+thin_plate_spline::factorization_map thin_plate_spline::_shared;
+std::atomic<uint64_t> thin_plate_spline::_timestep(0);
+
+void thin_plate_spline::build_system(const sample_view& samples)
 {
-    //see if we can reuse our
-    if(sample_points.size() +1 != size)
-    {
-        size = sample_points.size();
-        size++; // need to make room for the physics
-        A = MatrixXXd::Zero(size,size);
-        b = VectorXd::Zero(size);
-        x = VectorXd::Zero(size);
-    }
+    A.setZero();
 
-    if(uninit_lu_decomp)
+    _t.resize(size);
+    for (unsigned int i = 0; i < size - 1; i++)
     {
-        //build the LU decomp
-        for (unsigned int i = 0; i < size - 1; i++)
+        double sxi = samples.x[i]; //x
+        double syi = samples.y[i]; //y
+
+        // the upper triangle of row i, the diagonal is 0
+        size_t n = size - 2 - i;
+        for (unsigned int j = i + 1; j < size - 1; j++)
         {
-            double sxi = sample_points.at(i).get<0>(); //x
-            double syi = sample_points.at(i).get<1>(); //y
+            _t[j - i - 1] = scaled_distance(sxi, syi, samples.x[j], samples.y[j]);
+        }
+        kernel(_t.data(), n);
 
-            for (unsigned int j = i; j < size - 1; j++)
-            {
-                double sxj = sample_points.at(j).get<0>(); //x
-                double syj = sample_points.at(j).get<1>(); //y
+        for (unsigned int j = i + 1; j < size - 1; j++)
+        {
+            //don't add in a duplicate point, otherwise we get nan
+            if (samples.x[j] == sxi && samples.y[j] == syi)
+                continue;
 
-                double xdiff = (sxi - sxj);
-                double ydiff = (syi - syj);
+            double Rd = _t[j - i - 1];
+            A(i, j + 1) = Rd;
+            A(j, i + 1) = Rd;
+        }
+    }
 
-                //don't add in a duplicate point, otherwise we get nan
-                if (xdiff == 0. && ydiff == 0.)
-                    continue;
 
-                double Rd = 0.;
-                if (j == i) // diagonal
-                {
-                    Rd = 0.0;
-                } else
-                {
-                    double dij = sqrt(xdiff * xdiff + ydiff * ydiff); //distance between this set of observation points
+    //set physics and build b values
+    for (unsigned int i = 0; i < size; i++)
+    {
+        A(i, 0) = 1;
+        A(size - 1, i) = 1;
+    }
+    A(size - 1, 0) = 0;
+}
 
-                    //none of the books and papers, despite citing Helena Mitášová, Lubos Mitáš seem to agree on the exact formula
-                    //so I am following http://link.springer.com/article/10.1007/BF00893171#page-1
-                    // eqn 10
+std::shared_ptr<const thin_plate_spline::factorization> thin_plate_spline::shared_lu(const sample_view& samples)
+{
+    // thread local so the key doesn't allocate once warmed up
+    static thread_local std::vector<double> xy;
+    xy.resize(samples.n * 2 + 2);
+    for (size_t i = 0; i < samples.n; i++)
+    {
+        xy[2 * i] = samples.x[i];
+        xy[2 * i + 1] = samples.y[i];
+    }
+    xy[xy.size() - 2] = weight;
+    xy.back() = gsl_kernel ? 1. : 0.;
 
-                    dij = (dij * weight / 2.0) * (dij * weight / 2.0);
+    uint64_t key = wyhash(xy.data(), xy.size() * sizeof(double), 0);
 
-                    //Chang 4th edition 2008 uses bessel_k0
-                    //gsl_sf_bessel_K0
-                    // and has a -0.5 weight out fron
-//                     Rd = -0.5/(pi*weight*weight)*( log(dij*weight/2.0) + c + gsl_sf_bessel_K0(dij*weight));
+    {
+        factorization_map::const_accessor it;
+        if (_shared.find(it, key))
+        {
+            if (it->second->xy == xy)
+            {
+                // only store on a change, so the faces sharing a factorization don't all write to it every timestep
+                uint64_t t = _timestep.load(std::memory_order_relaxed);
+                if (it->second->last_used.load(std::memory_order_relaxed) != t)
+                    it->second->last_used.store(t, std::memory_order_relaxed);
+                return it->second;
+            }
 
-                    //And Hengl and Evans in geomorphometry p.52 do not, but have some undefined omega_0/omega_1 weights
-                    //it is all rather confusing. But this follows Mitášová exactly, and produces essentially the same answer
-                    //as the worked example in box 16.2 in Chang
-                    Rd = -(log(dij) + c + gsl_sf_expint_E1(dij));
+            // a hash collision with another set of stations, don't share this one
+            build_system(samples);
+            auto f = std::make_shared<factorization>();
+            f->lu.compute(A);
+            return f;
+        }
+    }
 
-                }
+    build_system(samples);
+    auto f = std::make_shared<factorization>();
+    f->xy = xy;
+    f->lu.compute(A);
+    f->bytes = sizeof(factorization) + (f->lu.matrixLU().size() + xy.size()) * sizeof(double) +
+               2 * A.rows() * sizeof(int);
+    f->last_used = _timestep.load(std::memory_order_relaxed);
 
-                A(i, j + 1) = Rd;
-                A(j, i + 1) = Rd;
+    // another thread may have factored the same stations in the meantime, in which case theirs is kept
+    factorization_map::accessor it;
+    if (_shared.insert(it, key))
+        it->second = f;
 
-            }
-        }
+    return it->second->xy == xy ? it->second : f;
+}
+
+size_t thin_plate_spline::shared_factorizations()
+{
+    return _shared.size();
+}
+
+size_t thin_plate_spline::shared_factorization_bytes()
+{
+    size_t bytes = 0;
+    for (auto& e : _shared)
+        bytes += e.second->bytes;
+    return bytes;
+}
 
+void thin_plate_spline::trim_shared_factorizations(size_t max_bytes)
+{
+    // (last used, bytes, key)
+    std::vector<std::tuple<uint64_t, size_t, uint64_t> > entries;
+    entries.reserve(_shared.size());
+    size_t bytes = 0;
+    for (auto& e : _shared)
+    {
+        entries.emplace_back(e.second->last_used.load(std::memory_order_relaxed), e.second->bytes, e.first);
+        bytes += e.second->bytes;
+    }
 
-        //set physics and build b values
-        for (unsigned int i = 0; i < size; i++)
+    if (bytes > max_bytes)
+    {
+        // oldest first, so the stations in use are the last to go
+        std::sort(entries.begin(), entries.end());
+        for (auto& e : entries)
         {
-            A(i, 0) = 1;
-            A(size - 1, i) = 1;
+            if (bytes <= max_bytes)
+                break;
+            _shared.erase(std::get<2>(e));
+            bytes -= std::get<1>(e);
         }
-        A(size - 1, 0) = 0;
-        lu.compute(A);
     }
 
+    ++_timestep;
+}
+
+const thin_plate_spline::LU& thin_plate_spline::factorize(const sample_view& samples,
+                                                            std::shared_ptr<const factorization>& shared)
+{
+    //see if we can reuse our
+    if(samples.n +1 != size)
+    {
+        size = samples.n;
+        size++; // need to make room for the physics
+        A = MatrixXXd::Zero(size,size);
+        b = VectorXd::Zero(size);
+        _c = VectorXd::Zero(size);
+        x = VectorXd::Zero(size);
+    }
+
+    if(share_LU && !reuse_LU)
+    {
+        shared = shared_lu(samples);
+        return shared->lu;
+    }
+
+    if(uninit_lu_decomp)
+    {
+        //build the LU decomp
+        build_system(samples);
+        lu.compute(A);
+    }
 
     //this will skip the above computation of the lu decomp next time this is called
     if(reuse_LU)
         uninit_lu_decomp = false;
 
+    return lu;
+}
+
+template<typename M>
+void thin_plate_spline::solve(const LU& factor, const M& rhs, M& c, M& dst)
+{
+    // FullPivLU::solve, but with the permuted right hand side in c rather than a temporary, so a warmed up spline
+    // doesn't allocate
+    Eigen::Index rank = factor.rank();
+    if(rank == 0)
+    {
+        dst.setZero();
+        return;
+    }
+
+    c.noalias() = factor.permutationP() * rhs;
+    factor.matrixLU().template triangularView<Eigen::UnitLower>().solveInPlace(c);
+    factor.matrixLU().topLeftCorner(rank, rank).template triangularView<Eigen::Upper>().solveInPlace(c.topRows(rank));
+
+    for(Eigen::Index i = 0; i < rank; i++)
+        dst.row(factor.permutationQ().indices().coeff(i)) = c.row(i);
+    for(Eigen::Index i = rank; i < factor.cols(); i++)
+        dst.row(factor.permutationQ().indices().coeff(i)).setZero();
+}
+
+double thin_plate_spline::scaled_distance(double sx, double sy, double ex, double ey) const
+{
+    double xdiff = (sx  - ex);
+    double ydiff = (sy  - ey);
+    double dij = sqrt(xdiff*xdiff + ydiff*ydiff); //distance between this set of observation points
+
+    //none of the books and papers, despite citing Helena Mitášová, Lubos Mitáš seem to agree on the exact formula
+    //so I am following http://link.springer.com/article/10.1007/BF00893171#page-1
+    // eqn 10
+    return (dij * weight/2.0) * (dij * weight/2.0);
+}
+
+void thin_plate_spline::kernel(double* t, size_t n) const
+{
+    //Chang 4th edition 2008 uses bessel_k0
+    //gsl_sf_bessel_K0
+    // and has a -0.5 weight out fron
+//    Rd = -0.5/(pi*weight*weight)*( log(dij*weight/2.0) + c + gsl_sf_bessel_K0(dij*weight));
+
+    //And Hengl and Evans in geomorphometry p.52 do not, but have some undefined omega_0/omega_1 weights
+    //it is all rather confusing. But this follows Mitášová exactly, and produces essentially the same answer
+    //as the worked example in box 16.2 in Chang
+    // Rd = -(log(dij) + c + E1(dij))
+    if (gsl_kernel)
+    {
+        for (size_t i = 0; i < n; i++)
+            t[i] = -(log(t[i]) + c + gsl_sf_expint_E1(t[i]));
+        return;
+    }
+
+    // log + E1 is evaluated as Ein, which has the exact Euler constant in it
+    math::ein(t, t, n);
+    for (size_t i = 0; i < n; i++)
+        t[i] = -(t[i] + (c - math::euler_gamma));
+}
+
+double thin_plate_spline::operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point)
+{
+    std::shared_ptr<const factorization> shared;
+    const LU& factor = factorize(samples, shared);
+
     for(size_t i=0;i<size-1;i++)
     {
-        b(i) = sample_points.at(i).get<2>() ;
+        b(i) = samples.z[i] ;
     }
 
     b(size-1) = 0.0; //constant
 
     //solve equation
-    int s				= 0;
-
-    x =  lu.solve(b) ; //ldlt.solve(b);
+    solve(factor, b, _c, x);
 
 
     double z0 = x(0);//little a
@@ -123,23 +279,67 @@ double thin_plate_spline::operator()(std::vector< boost::tuple<double,double,dou
     double ex = query_point.get<0>();
     double ey =  query_point.get<1>();
 
+    _t.resize(size);
     for (unsigned int i = 1; i < x.size() ;i++)
     {
-        double sx = sample_points.at(i-1).get<0>(); //x
-        double sy = sample_points.at(i-1).get<1>(); //y
+        double sx = samples.x[i-1]; //x
+        double sy = samples.y[i-1]; //y
 
-        double xdiff = (sx  - ex);
-        double ydiff = (sy  - ey);
-        double dij = sqrt(xdiff*xdiff + ydiff*ydiff);
-        dij = (dij * weight/2.0) * (dij * weight/2.0);
-        double Rd = -(log(dij) + c + gsl_sf_expint_E1(dij));
+        _t[i-1] = scaled_distance(sx, sy, ex, ey);
+    }
+    kernel(_t.data(), size - 1);
 
-        z0 = z0 + x(i)*Rd;
+    for (unsigned int i = 1; i < x.size() ;i++)
+    {
+        z0 = z0 + x(i)*_t[i-1];
     }
 
     return z0;
 }
 
+void thin_plate_spline::operator()(const sample_view& samples, const double* values, size_t nvars,
+                                   const boost::tuple<double,double,double>& query_point, double* out)
+{
+    std::shared_ptr<const factorization> shared;
+    const LU& factor = factorize(samples, shared);
+
+    // one right hand side per variable
+    if(_B.rows() != (Eigen::Index)size || _B.cols() != (Eigen::Index)nvars)
+    {
+        _B = MatrixXXd::Zero(size, nvars);
+        _C = MatrixXXd::Zero(size, nvars);
+        _X = MatrixXXd::Zero(size, nvars);
+    }
+
+    for(size_t i=0;i<size-1;i++)
+    {
+        for(size_t k=0;k<nvars;k++)
+            _B(i, k) = values[i * nvars + k];
+    }
+    _B.row(size-1).setZero(); //constant
+
+    solve(factor, _B, _C, _X);
+
+    for(size_t k=0;k<nvars;k++)
+        out[k] = _X(0, k);
+
+    // the kernel only depends on the locations, so it is evaluated once for all the variables
+    double ex = query_point.get<0>();
+    double ey =  query_point.get<1>();
+    _t.resize(size);
+    for (size_t i = 1; i < size; i++)
+    {
+        _t[i-1] = scaled_distance(samples.x[i-1], samples.y[i-1], ex, ey);
+    }
+    kernel(_t.data(), size - 1);
+
+    for (size_t i = 1; i < size; i++)
+    {
+        for(size_t k=0;k<nvars;k++)
+            out[k] += _X(i, k) * _t[i-1];
+    }
+}
+
 thin_plate_spline::thin_plate_spline(size_t sz, std::map<std::string,std::string> config )
 : thin_plate_spline()
 {
@@ -149,6 +349,7 @@ thin_plate_spline::thin_plate_spline(size_t sz, std::map<std::string,std::string
 
     A = MatrixXXd::Zero(size,size);
     b = VectorXd::Zero(size);
+    _c = VectorXd::Zero(size);
     x = VectorXd::Zero(size);
 
     auto itr = config.find("reuse_LU");
@@ -158,6 +359,20 @@ thin_plate_spline::thin_plate_spline(size_t sz, std::map<std::string,std::string
             reuse_LU = true;
     }
 
+    itr = config.find("share_LU");
+    if(itr != config.end())
+    {
+        if(config["share_LU"] == "false")
+            share_LU = false;
+    }
+
+    itr = config.find("kernel");
+    if(itr != config.end())
+    {
+        if(config["kernel"] == "gsl")
+            gsl_kernel = true;
+    }
+
 }
 thin_plate_spline::thin_plate_spline()
 {
@@ -167,6 +382,8 @@ thin_plate_spline::thin_plate_spline()
     size        = 0;
 
     reuse_LU    = false;
+    share_LU    = true;
+    gsl_kernel  = false;
     uninit_lu_decomp = true;
 
 
@@ -31,7 +31,11 @@
 
 #include <boost/throw_exception.hpp>
 #include <exception.hpp>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <vector>
+#include <tbb/concurrent_hash_map.h>
 #include "interp_base.hpp"
 #include "logger.hpp"
 
@@ -39,6 +43,14 @@
 * \class thin_plate_spline
 *
 * Thin plate spline with tensions interpolation
+*
+* The LU factorization of the spline system only depends on the sample point locations, and neighbouring faces generally
+* interpolate from the same stations. Unless reuse_LU is set, factorizations are shared by all the splines in the process,
+* keyed on the sample point locations, so each set of stations (less any that are nan and have been dropped by the caller)
+* is factored once and then only solved for the values.
+*
+* The kernel, log + E1 of the scaled distance, is evaluated for a row of stations at a time with the vectorized
+* approximation in math/expint.hpp. Setting kernel to gsl in the config uses GSL's E1 instead, as a reference.
 */
 class thin_plate_spline : public interp_base
 {
@@ -53,23 +65,103 @@ public:
     thin_plate_spline(size_t sz,std::map<std::string,std::string> config = std::map<std::string,std::string>());
 
     /**
-    * Spline of the sample_points at the query_point location.
-    * \param sample_points Tuple of x,y,z values that comprise the sample points from which to interpolate from
+    * Spline of the samples at the query_point location.
+    * \param samples The sample points from which to interpolate from
     * \param query_point Tuple of x,y,z value that is the point to interpolate to
     * \return Interpolated value at the query_point
     */
-    double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point);
+    double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point);
+
+    /**
+    * Spline of several variables at the same sample points. The system is factored once and solved for all the variables
+    * together, and the kernel is evaluated once per sample point.
+    * \param samples The sample points, z is not used
+    * \param values Sample values, values[i*nvars + k] is variable k at sample point i
+    * \param nvars Number of variables
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \param out The nvars interpolated values
+    */
+    void operator()(const sample_view& samples, const double* values, size_t nvars,
+                    const boost::tuple<double,double,double>& query_point, double* out);
+
+    using interp_base::operator();
 
     bool reuse_LU;
+
+    /**
+     * Disables the shared factorizations for this spline, it then factors the system on every call
+     */
+    bool share_LU;
+
+    /**
+     * Evaluates the kernel with GSL's E1 rather than the approximation of Ein, as a reference
+     */
+    bool gsl_kernel;
+
+    /**
+     * Number of shared factorizations currently held
+     */
+    static size_t shared_factorizations();
+
+    /**
+     * Approximate memory held by the shared factorizations, in bytes
+     */
+    static size_t shared_factorization_bytes();
+
+    /**
+     * Releases the least recently used shared factorizations until at most max_bytes are held, then starts a new
+     * timestep for the last used stamps. Not thread safe with respect to the splines, so call between timesteps.
+     * \param max_bytes
+     */
+    static void trim_shared_factorizations(size_t max_bytes);
+
 private:
     typedef Eigen::Matrix<double,Eigen::Dynamic,1> VectorXd;
     typedef Eigen::Matrix<double,Eigen::Dynamic, Eigen::Dynamic> MatrixXXd;
+    typedef Eigen::FullPivLU< Eigen::Matrix<double,Eigen::Dynamic, Eigen::Dynamic> > LU;
+
+    // a factorization and the sample locations it was built from, to confirm a hash match
+    struct factorization
+    {
+        std::vector<double> xy;
+        LU lu;
+        size_t bytes; // approximate size, dominated by the n^2 LU matrix
+        mutable std::atomic<uint64_t> last_used; // timestep this was last used in, for the eviction in trim
+    };
+    typedef tbb::concurrent_hash_map<uint64_t, std::shared_ptr<const factorization> > factorization_map;
+    static factorization_map _shared;
+    static std::atomic<uint64_t> _timestep;
+
+    // fills A with the spline system for the sample locations
+    void build_system(const sample_view& samples);
+
+    // sizes the system and returns the factorization to use for the sample locations. shared holds it if it is shared
+    const LU& factorize(const sample_view& samples,
+                        std::shared_ptr<const factorization>& shared);
+
+    // solves factor * dst = rhs, c is scratch of the same shape
+    template<typename M>
+    void solve(const LU& factor, const M& rhs, M& c, M& dst);
+
+    // kernel argument for the distance between a sample point and another point
+    double scaled_distance(double sx, double sy, double ex, double ey) const;
+
+    // replaces the n kernel arguments in t with the spline kernel
+    void kernel(double* t, size_t n) const;
+
+    // finds or builds the shared factorization for the sample locations
+    std::shared_ptr<const factorization> shared_lu(const sample_view& samples);
 
     MatrixXXd A ;
     VectorXd b; // known values - constant value of 0 goes in b[size-1]
     VectorXd x;
+    VectorXd _c; // scratch for the solve
+
+    // right hand sides, scratch and solutions for the multi-variable spline
+    MatrixXXd _B, _C, _X;
+    std::vector<double> _t; // kernel arguments and values for a row of the system or the query point
 
-    Eigen::FullPivLU< Eigen::Matrix<double,Eigen::Dynamic, Eigen::Dynamic> > lu;
+    LU lu;
     double pi;
     double c; //euler constant
     double weight;
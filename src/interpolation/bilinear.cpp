@@ -0,0 +1,143 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "bilinear.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    inline double cross(double ax, double ay, double bx, double by)
+    {
+        return ax * by - ay * bx;
+    }
+
+    // how far (u,v) is outside of the unit cell, 0 if inside
+    inline double outside(double u, double v)
+    {
+        if (!std::isfinite(u) || !std::isfinite(v))
+            return std::numeric_limits<double>::max();
+
+        return std::max({0., -u, u - 1.}) + std::max({0., -v, v - 1.});
+    }
+}
+
+bilinear::bilinear()
+{
+
+}
+
+bilinear::~bilinear()
+{
+
+}
+
+bool bilinear::cell_coordinates(const double* x, const double* y, double qx, double qy, double& u, double& v)
+{
+    // p = p0 + u*e + v*f + u*v*g
+    double ex = x[1] - x[0], ey = y[1] - y[0];
+    double fx = x[2] - x[0], fy = y[2] - y[0];
+    double gx = x[0] - x[1] - x[2] + x[3], gy = y[0] - y[1] - y[2] + y[3];
+    double hx = qx - x[0], hy = qy - y[0];
+
+    // eliminating u leaves k2*v^2 + k1*v + k0 = 0, with k2 = 0 for a parallelogram
+    double k2 = cross(gx, gy, fx, fy);
+    double k1 = cross(ex, ey, fx, fy) + cross(hx, hy, gx, gy);
+    double k0 = cross(hx, hy, ex, ey);
+
+    // far outside of a strongly warped cell there may not be a real root, take the closest
+    double disc = std::sqrt(std::max(0., k1 * k1 - 4 * k0 * k2));
+
+    // the cancellation free form of the roots, the second one is -k0/k1 when k2 = 0
+    double q = -0.5 * (k1 + std::copysign(disc, k1));
+    double roots[2] = {q / k2, k0 / q};
+
+    u = v = std::numeric_limits<double>::quiet_NaN();
+    double best = std::numeric_limits<double>::max();
+    for (double r : roots)
+    {
+        // u from h - v*f = u*(e + v*g), along the larger component
+        double dx = ex + gx * r, dy = ey + gy * r;
+        double ru = std::fabs(dx) > std::fabs(dy) ? (hx - fx * r) / dx : (hy - fy * r) / dy;
+
+        double d = outside(ru, r);
+        if (d < best)
+        {
+            best = d;
+            u = ru;
+            v = r;
+        }
+    }
+
+    if (best == std::numeric_limits<double>::max())
+    {
+        BOOST_THROW_EXCEPTION(interpolation_error() << errstr_info("Degenerate bilinear cell"));
+    }
+
+    return best == 0;
+}
+
+void bilinear::weights(const double* x, const double* y, double qx, double qy, double* w)
+{
+    double u, v;
+    cell_coordinates(x, y, qx, qy, u, v);
+
+    u = std::min(std::max(u, 0.), 1.);
+    v = std::min(std::max(v, 0.), 1.);
+
+    w[0] = (1 - u) * (1 - v);
+    w[1] = u * (1 - v);
+    w[2] = (1 - u) * v;
+    w[3] = u * v;
+}
+
+double bilinear::operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point)
+{
+    if (samples.n != 4)
+        return _idw(samples, query_point);
+
+    double w[4];
+    weights(samples.x, samples.y, query_point.get<0>(), query_point.get<1>(), w);
+
+    return w[0] * samples.z[0] + w[1] * samples.z[1] + w[2] * samples.z[2] + w[3] * samples.z[3];
+}
+
+void bilinear::operator()(const sample_view& samples, const double* values, size_t nvars,
+                          const boost::tuple<double,double,double>& query_point, double* out)
+{
+    if (samples.n != 4)
+    {
+        _idw(samples, values, nvars, query_point, out);
+        return;
+    }
+
+    double w[4];
+    weights(samples.x, samples.y, query_point.get<0>(), query_point.get<1>(), w);
+
+    for (size_t k = 0; k < nvars; k++)
+    {
+        out[k] = w[0] * values[k] + w[1] * values[nvars + k] +
+                 w[2] * values[2 * nvars + k] + w[3] * values[3 * nvars + k];
+    }
+}
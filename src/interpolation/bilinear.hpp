@@ -0,0 +1,90 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include "interp_base.hpp"
+#include "inv_dist.hpp"
+
+/**
+* \class bilinear
+* Bilinear interpolation within one cell of a structured grid, e.g., the NetCDF forcing grid. The 4 sample points are the
+* cell corners in grid order (i,j), (i+1,j), (i,j+1), (i+1,j+1). The grid is usually a lat/long grid projected to the
+* mesh's coordinate system, so the cell is a general quadrilateral and the bilinear map is inverted to find the query
+* point's cell coordinates (u,v). Outside of the cell (u,v) are clamped to [0,1], i.e., the closest edge is used.
+*
+* If there aren't 4 sample points, e.g., a corner was skipped for being nan, there is no cell and IDW is used instead.
+*/
+class bilinear : public interp_base
+{
+public:
+    bilinear();
+    ~bilinear();
+
+    /**
+    * Bilinear interpolation of the cell corners at the query_point location
+    * \param samples The 4 cell corners, in grid order
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \return Interpolated value at the query_point
+    */
+    double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point);
+
+    /**
+    * Bilinear interpolation of several variables, the weights are computed once for all the variables
+    * \param samples The 4 cell corners, in grid order, z is not used
+    * \param values Sample values, values[i*nvars + k] is variable k at sample point i
+    * \param nvars Number of variables
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \param out The nvars interpolated values
+    */
+    void operator()(const sample_view& samples, const double* values, size_t nvars,
+                    const boost::tuple<double,double,double>& query_point, double* out);
+
+    using interp_base::operator();
+
+    /**
+    * Inverts the bilinear map of a cell, finding (u,v) such that the query point is
+    * (1-u)(1-v)*p0 + u(1-v)*p1 + (1-u)v*p2 + uv*p3. The results are not clamped.
+    * \param x The 4 corners, in grid order
+    * \param y
+    * \param qx Query point
+    * \param qy
+    * \param u Cell coordinate along i
+    * \param v Cell coordinate along j
+    * \return True if the query point is in the cell
+    */
+    static bool cell_coordinates(const double* x, const double* y, double qx, double qy, double& u, double& v);
+
+    /**
+    * Computes the weights of the 4 corners of a cell for the query point, clamped to the cell
+    * \param x The 4 corners, in grid order
+    * \param y
+    * \param qx Query point
+    * \param qy
+    * \param w The 4 weights, sum to 1
+    */
+    static void weights(const double* x, const double* y, double qx, double qy, double* w);
+
+private:
+    inv_dist _idw;
+};
@@ -0,0 +1,158 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "idw_weights.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+const size_t idw_weights::none;
+
+idw_weights::idw_weights()
+{
+
+}
+
+void idw_weights::init(const std::vector<size_t>& offsets,
+                       const std::vector<uint32_t>& stations,
+                       const std::vector<double>& station_x,
+                       const std::vector<double>& station_y,
+                       const std::vector<double>& query_x,
+                       const std::vector<double>& query_y)
+{
+    size_t rows = offsets.size() - 1;
+
+    _offsets = offsets;
+    _stations = stations;
+    _weights.assign(stations.size(), 0.);
+    _nearest.assign(rows, 0);
+    _on_station.assign(rows, none);
+
+#pragma omp parallel for
+    for (size_t i = 0; i < rows; i++)
+    {
+        double sum = 0;
+        double closest = std::numeric_limits<double>::max();
+
+        for (size_t k = offsets[i]; k < offsets[i + 1]; k++)
+        {
+            double xdiff = station_x[stations[k]] - query_x[i];
+            double ydiff = station_y[stations[k]] - query_y[i];
+            double d2 = xdiff * xdiff + ydiff * ydiff;
+
+            if (d2 < closest)
+            {
+                closest = d2;
+                _nearest[i] = stations[k];
+            }
+
+            if (d2 == 0)
+            {
+                // the query point is on this station, which overrides the weights below unless its value is nan
+                if (_on_station[i] == none)
+                    _on_station[i] = k;
+            }
+            else
+            {
+                _weights[k] = 1 / d2;
+                sum += _weights[k];
+            }
+        }
+
+        // sum is 0 if the row only has stations the query point is on
+        if (sum > 0)
+        {
+            for (size_t k = offsets[i]; k < offsets[i + 1]; k++)
+                _weights[k] /= sum;
+        }
+    }
+}
+
+void idw_weights::init(const std::vector<size_t>& offsets,
+                       const std::vector<uint32_t>& stations,
+                       const std::vector<double>& weights)
+{
+    size_t rows = offsets.size() - 1;
+
+    _offsets = offsets;
+    _stations = stations;
+    _weights = weights;
+    _nearest.assign(rows, 0);
+    _on_station.assign(rows, none);
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        auto first = _weights.begin() + offsets[i];
+        auto last = _weights.begin() + offsets[i + 1];
+        if (first != last)
+            _nearest[i] = _stations[offsets[i] + (std::max_element(first, last) - first)];
+    }
+}
+
+void idw_weights::interpolate(const double* values, double* out) const
+{
+#pragma omp parallel for
+    for (size_t i = 0; i < rows(); i++)
+    {
+        out[i] = (*this)(i, values);
+    }
+}
+
+void idw_weights::operator()(size_t row, const double* values, size_t nvars, double* out) const
+{
+    // the sum of the weights only differs between variables if some are nan
+    for (size_t j = 0; j < nvars; j++)
+    {
+        if (_on_station[row] != none)
+        {
+            double v = values[_stations[_on_station[row]] * nvars + j];
+            if (v == v)
+            {
+                out[j] = v;
+                continue;
+            }
+        }
+
+        double num = 0;
+        double den = 0;
+        for (size_t k = _offsets[row]; k < _offsets[row + 1]; k++)
+        {
+            double v = values[_stations[k] * nvars + j];
+            if (v == v)
+            {
+                num += _weights[k] * v;
+                den += _weights[k];
+            }
+        }
+        out[j] = den > 0 ? num / den : std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+void idw_weights::interpolate(const double* values, size_t nvars, double* out) const
+{
+#pragma omp parallel for
+    for (size_t i = 0; i < rows(); i++)
+    {
+        (*this)(i, values, nvars, out + i * nvars);
+    }
+}
@@ -0,0 +1,147 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+* \class idw_weights
+*
+* Inverse distance weights from a fixed set of stations to a fixed set of query points, e.g., each face from its station
+* list. The station and query locations don't change during a run, so the weights are computed once and stored in a
+* compressed sparse row layout, one row per query point. Interpolation is then a sparse matrix-vector product with the
+* station values. Stations whose value is nan are skipped and the remaining weights of the row renormalized.
+*
+* Weights follow inv_dist, 1/d^2, and a query point on top of a station takes that station's value, or the 1/d^2 weighting
+* of the other stations if that value is nan. Other static weights,
+* e.g., the bilinear weights of each face's forcing grid cell, may be given instead.
+*/
+class idw_weights
+{
+public:
+    idw_weights();
+
+    /**
+     * Computes the weights
+     * \param offsets Start of each query point's stations in stations, with a final entry for the end. Length = rows+1
+     * \param stations Station indices, into station_x/station_y and later the station values
+     * \param station_x Station locations
+     * \param station_y
+     * \param query_x Query point locations, one per row
+     * \param query_y
+     */
+    void init(const std::vector<size_t>& offsets,
+              const std::vector<uint32_t>& stations,
+              const std::vector<double>& station_x,
+              const std::vector<double>& station_y,
+              const std::vector<double>& query_x,
+              const std::vector<double>& query_y);
+
+    /**
+     * Uses precomputed weights instead of the inverse distance ones
+     * \param offsets Start of each query point's stations in stations, with a final entry for the end. Length = rows+1
+     * \param stations Station indices, into the station values
+     * \param weights One per entry of stations, summing to 1 for each row
+     */
+    void init(const std::vector<size_t>& offsets,
+              const std::vector<uint32_t>& stations,
+              const std::vector<double>& weights);
+
+    /**
+     * Interpolates to one query point
+     * \param row Query point
+     * \param values Station values, indexed as the stations passed to init. nan values are skipped
+     * \return Interpolated value, nan if all the row's stations are nan
+     */
+    inline double operator()(size_t row, const double* values) const
+    {
+        if (_on_station[row] != none)
+        {
+            double v = values[_stations[_on_station[row]]];
+            if (v == v)
+                return v;
+        }
+
+        double num = 0;
+        double den = 0;
+        for (size_t k = _offsets[row]; k < _offsets[row + 1]; k++)
+        {
+            double v = values[_stations[k]];
+            if (v == v) // skip nan
+            {
+                num += _weights[k] * v;
+                den += _weights[k];
+            }
+        }
+
+        // den == 1 unless stations were skipped
+        return den > 0 ? num / den : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /**
+     * Interpolates several variables to one query point, with the nan stations skipped per variable
+     * \param row Query point
+     * \param values Station values, values[station*nvars + k] is variable k
+     * \param nvars Number of variables
+     * \param out The nvars interpolated values
+     */
+    void operator()(size_t row, const double* values, size_t nvars, double* out) const;
+
+    /**
+     * Interpolates to all the query points
+     * \param values Station values, indexed as the stations passed to init. nan values are skipped
+     * \param out One value per row
+     */
+    void interpolate(const double* values, double* out) const;
+
+    /**
+     * Interpolates several variables to all the query points
+     * \param values Station values, values[station*nvars + k] is variable k
+     * \param nvars Number of variables
+     * \param out out[row*nvars + k] is variable k at the query point
+     */
+    void interpolate(const double* values, size_t nvars, double* out) const;
+
+    /**
+     * Index of the closest station of a query point, or for precomputed weights the one with the largest weight
+     * \param row
+     * \return
+     */
+    uint32_t nearest(size_t row) const { return _nearest[row]; }
+
+    /// Number of query points
+    size_t rows() const { return _nearest.size(); }
+
+private:
+    static const size_t none = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> _offsets;
+    std::vector<uint32_t> _stations;
+    std::vector<double> _weights; // normalized per row, 0 for a station the query point is on
+    std::vector<uint32_t> _nearest;
+    std::vector<size_t> _on_station; // entry of the station the query point is on, used while its value isn't nan, or none
+};
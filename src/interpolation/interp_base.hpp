@@ -22,15 +22,80 @@
 //
 
 #pragma once
+#include <cstddef>
 #include <vector>
 #include <boost/tuple/tuple.hpp>
 #include <cmath>
 
 #include "exception.hpp"
 
+/**
+* \struct sample_view
+* Structure of arrays view of n sample points at x[i], y[i] with value z[i]. The arrays are not owned. z isn't used by
+* the multi-variable interpolation, which takes the values separately, and may be null there.
+*/
+struct sample_view
+{
+    const double* x;
+    const double* y;
+    const double* z;
+    size_t n;
+};
+
+/**
+* \class interp_samples
+* Reusable storage for sample points. clear() keeps the capacity, so a thread_local instance that has grown to the number
+* of stations builds each face's sample points without allocating:
+* \code
+* static thread_local interp_samples samples;
+* samples.clear();
+* for (auto& s : face->stations())
+*     samples.push_back(s->x(), s->y(), (*s)["t"_s]);
+* double t = interp(samples.view(), query);
+* \endcode
+*/
+class interp_samples
+{
+public:
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+        values.clear();
+    }
+
+    void push_back(double px, double py, double pz = 0.)
+    {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+    }
+
+    size_t size() const
+    {
+        return x.size();
+    }
+
+    sample_view view() const
+    {
+        return sample_view{x.data(), y.data(), z.data(), x.size()};
+    }
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    // values for the multi-variable interpolation, values[i*nvars + k] is variable k at sample point i
+    std::vector<double> values;
+};
+
 /**
 * \class interp_base
 * Base class for all interpolation schemes to inherent from.
+*
+* Schemes implement the sample_view methods. The vector of tuple versions copy into a per-thread buffer and call those,
+* so a derived class needs a using interp_base::operator() to keep them visible.
 */
 class interp_base
 {
@@ -38,16 +103,66 @@ public:
 
     /**
     * The interpolation method must implement this method.
+    * \param samples The sample points from which to interpolate from
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \return Interpolated value at the query_point
+    */
+    virtual double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point) = 0;
+
+    /**
+    * Interpolates several variables sampled at the same points. Implementations share the weights or factorization
+    * between the variables.
+    * \param samples The sample points, z is not used
+    * \param values Sample values, values[i*nvars + k] is variable k at sample point i
+    * \param nvars Number of variables
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \param out The nvars interpolated values
+    */
+    virtual void operator()(const sample_view& samples, const double* values, size_t nvars,
+                            const boost::tuple<double,double,double>& query_point, double* out) = 0;
+
+    /**
     * \param sample_points Tuple of x,y,z values that comprise the sample points from which to interpolate from
     * \param query_point Tuple of x,y,z value that is the point to interpolate to
     * \return Interpolated value at the query_point
     */
-    virtual double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point)
+    double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point)
+    {
+        return (*this)(to_view(sample_points), query_point);
+    };
+
+    /**
+    * \param sample_points Tuple of x,y values of the sample points, z is not used
+    * \param values Sample values, values[i*nvars + k] is variable k at sample point i
+    * \param nvars Number of variables
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \param out The nvars interpolated values
+    */
+    void operator()(std::vector< boost::tuple<double,double,double> >& sample_points,
+                    const std::vector<double>& values, size_t nvars,
+                    boost::tuple<double,double,double>& query_point, double* out)
     {
-        return -9999.0;
+        if (values.size() < sample_points.size() * nvars)
+        {
+            BOOST_THROW_EXCEPTION(interpolation_error() << errstr_info("Fewer interpolation values than sample points and variables."));
+        }
+
+        (*this)(to_view(sample_points), values.data(), nvars, query_point, out);
     };
 
     virtual ~interp_base(){};
     interp_base(){};
 
-};
\ No newline at end of file
+private:
+    // copies the sample points into a per-thread buffer
+    static sample_view to_view(const std::vector< boost::tuple<double,double,double> >& sample_points)
+    {
+        static thread_local interp_samples buffer;
+        buffer.clear();
+        for (auto& p : sample_points)
+            buffer.push_back(p.get<0>(), p.get<1>(), p.get<2>());
+
+        return buffer.view();
+    }
+
+};
@@ -44,6 +44,10 @@ void interpolation::init(interp_alg ia, size_t size,std::map<std::string,std::st
     {
         base = boost::make_shared<nearest>();
     }
+    else if(ia == interp_alg::bilinear_grid)
+    {
+        base = boost::make_shared<bilinear>();
+    }
     else
     {
         BOOST_THROW_EXCEPTION(interp_unknown_type() << errstr_info("Unknown interpolation type"));
@@ -82,3 +86,56 @@ double interpolation::operator()(std::vector< boost::tuple<double,double,double>
 
     return base->operator()(sample_points,query_point);
 }
+
+void interpolation::operator()(std::vector< boost::tuple<double,double,double> >& sample_points,
+                               const std::vector<double>& values, size_t nvars,
+                               boost::tuple<double,double,double>& query_point, double* out)
+{
+    if (sample_points.size() == 0)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Interpolation sample point length = 0."));
+    }
+
+    if (values.size() != sample_points.size() * nvars)
+    {
+        BOOST_THROW_EXCEPTION(interpolation_error() << errstr_info("Interpolation values length doesn't match the sample points and variables."));
+    }
+
+    if (sample_points.size() > 15 && ia == interp_alg::tpspline)
+    {
+        LOG_WARNING << "More than 15 sample points is likely to cause slow downs";
+    }
+
+    base->operator()(sample_points, values, nvars, query_point, out);
+}
+
+double interpolation::operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point)
+{
+    if (samples.n == 0)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Interpolation sample point length = 0."));
+    }
+
+    if (samples.n > 15 && ia == interp_alg::tpspline)
+    {
+        LOG_WARNING << "More than 15 sample points is likely to cause slow downs";
+    }
+
+    return base->operator()(samples, query_point);
+}
+
+void interpolation::operator()(const sample_view& samples, const double* values, size_t nvars,
+                               const boost::tuple<double,double,double>& query_point, double* out)
+{
+    if (samples.n == 0)
+    {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Interpolation sample point length = 0."));
+    }
+
+    if (samples.n > 15 && ia == interp_alg::tpspline)
+    {
+        LOG_WARNING << "More than 15 sample points is likely to cause slow downs";
+    }
+
+    base->operator()(samples, values, nvars, query_point, out);
+}
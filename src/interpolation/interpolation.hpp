@@ -26,6 +26,8 @@
 #include "inv_dist.hpp"
 #include "nearest.hpp"
 #include "TPSpline.hpp"
+#include "bilinear.hpp"
+#include "idw_weights.hpp"
 
 #include <vector>
 #include <boost/tuple/tuple.hpp>
@@ -37,7 +39,8 @@ enum interp_alg
 {
     tpspline,
     idw,
-    nearest_sta
+    nearest_sta,
+    bilinear_grid
 };
 
 class interpolation
@@ -56,6 +59,24 @@ public:
     void init(interp_alg ia, size_t size=0, std::map<std::string,std::string> config = std::map<std::string,std::string>());
 
     double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point);
+
+    /*
+     * Interpolates several variables sampled at the same points in one call, sharing the weights, factorization and
+     * kernel evaluations between them. values[i*nvars + k] is variable k at sample point i, and the z of the
+     * sample points is not used. The nvars results are written to out.
+     */
+    void operator()(std::vector< boost::tuple<double,double,double> >& sample_points,
+                    const std::vector<double>& values, size_t nvars,
+                    boost::tuple<double,double,double>& query_point, double* out);
+
+    /*
+     * As above, from a structure of arrays view of the sample points. With the samples built in a reused
+     * interp_samples this doesn't allocate. For the multi-variable version values must hold samples.n * nvars values.
+     */
+    double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point);
+    void operator()(const sample_view& samples, const double* values, size_t nvars,
+                    const boost::tuple<double,double,double>& query_point, double* out);
+
     boost::shared_ptr<interp_base> base;
 private:
 
@@ -33,24 +33,24 @@ inv_dist::~inv_dist()
     
 }
 
-double inv_dist::operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point)
+double inv_dist::operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point)
 {
     
     double numerator = 0.0;
     double denominator = 0.0;
 
     double z0 = 0;
-    if (sample_points.size() == 0)
+    if (samples.n == 0)
     {
         BOOST_THROW_EXCEPTION( interpolation_error()
                                 << errstr_info("IDW requires >=1 stations"));
     }
-    for(size_t i=0;i<sample_points.size();i++)
+    for(size_t i=0;i<samples.n;i++)
     {
-        double z = sample_points.at(i).get<2>();
+        double z = samples.z[i];
 
-        double sx = sample_points.at(i).get<0>();
-        double sy = sample_points.at(i).get<1>();
+        double sx = samples.x[i];
+        double sy = samples.y[i];
         
         double ex = query_point.get<0>();
         double ey = query_point.get<1>();
@@ -79,3 +79,40 @@ double inv_dist::operator()(std::vector< boost::tuple<double,double,double> >& s
    return z0;
 
 }
+
+void inv_dist::operator()(const sample_view& samples, const double* values, size_t nvars,
+                          const boost::tuple<double,double,double>& query_point, double* out)
+{
+    if (samples.n == 0)
+    {
+        BOOST_THROW_EXCEPTION( interpolation_error()
+                                << errstr_info("IDW requires >=1 stations"));
+    }
+
+    for(size_t k=0;k<nvars;k++)
+        out[k] = 0;
+
+    double denominator = 0.0;
+    for(size_t i=0;i<samples.n;i++)
+    {
+        double xdiff = samples.x[i] - query_point.get<0>();
+        double ydiff = samples.y[i] - query_point.get<1>();
+        double di = xdiff*xdiff + ydiff*ydiff;
+
+        // on top of a sample point, as in the single variable version
+        double w = di == 0 ? 1.0 : 1.0 / di;
+        if(di == 0)
+        {
+            for(size_t k=0;k<nvars;k++)
+                out[k] = 0;
+            denominator = 0;
+        }
+
+        for(size_t k=0;k<nvars;k++)
+            out[k] += w * values[i * nvars + k];
+        denominator += w;
+    }
+
+    for(size_t k=0;k<nvars;k++)
+        out[k] /= denominator;
+}
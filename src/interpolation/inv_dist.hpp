@@ -38,10 +38,23 @@ public:
 
     /**
     * IDW of the sample_points at the query_point location.
-    * \param sample_points Tuple of x,y,z values that comprise the sample points from which to interpolate from
+    * \param samples The sample points from which to interpolate from
     * \param query_point Tuple of x,y,z value that is the point to interpolate to
     * \return Interpolated value at the query_point
     */
-    double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point);
+    double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point);
+
+    /**
+    * IDW of several variables at the same sample points, the weights are computed once for all the variables
+    * \param samples The sample points, z is not used
+    * \param values Sample values, values[i*nvars + k] is variable k at sample point i
+    * \param nvars Number of variables
+    * \param query_point Tuple of x,y,z value that is the point to interpolate to
+    * \param out The nvars interpolated values
+    */
+    void operator()(const sample_view& samples, const double* values, size_t nvars,
+                    const boost::tuple<double,double,double>& query_point, double* out);
+
+    using interp_base::operator();
            
 };
\ No newline at end of file
@@ -33,16 +33,29 @@ nearest::~nearest()
     
 }
 
-double nearest::operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point)
+double nearest::operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point)
 {
     double z0 = 0;
-    if (sample_points.size() > 1)
+    if (samples.n != 1)
     {
         BOOST_THROW_EXCEPTION( interpolation_error()
                                 << errstr_info("nearest requires exactly 1 station"));
     }
 
-    z0 = sample_points.at(0).get<2>();
+    z0 = samples.z[0];
     return z0;
 
 }
+
+void nearest::operator()(const sample_view& samples, const double* values, size_t nvars,
+                         const boost::tuple<double,double,double>& query_point, double* out)
+{
+    if (samples.n != 1)
+    {
+        BOOST_THROW_EXCEPTION( interpolation_error()
+                                << errstr_info("nearest requires exactly 1 station"));
+    }
+
+    for(size_t k=0;k<nvars;k++)
+        out[k] = values[k];
+}
@@ -38,10 +38,23 @@ public:
 
     /**
     * Nearest sample point
-    * \param sample_points Tuple of x,y,z values that comprise the sample points from which to interpolate from
+    * \param samples The sample points from which to interpolate from
     * \param query_point Tuple of x,y,z value that is the point to interpolate to
     * \return Interpolated value at the query_point
     */
-    double operator()(std::vector< boost::tuple<double,double,double> >& sample_points, boost::tuple<double,double,double>& query_point);
+    double operator()(const sample_view& samples, const boost::tuple<double,double,double>& query_point);
+
+    /**
+    * Nearest value of several variables
+    * \param samples The single sample point, z is not used
+    * \param values Sample values, one per variable
+    * \param nvars Number of variables
+    * \param query_point Not used
+    * \param out The nvars values
+    */
+    void operator()(const sample_view& samples, const double* values, size_t nvars,
+                    const boost::tuple<double,double,double>& query_point, double* out);
+
+    using interp_base::operator();
            
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "load_balancer.hpp"
+
+load_balancer::load_balancer()
+{
+    _nfaces = 0;
+    _block_size = 1;
+    _alpha = 0.5;
+    _measured = false;
+    _last_imbalance = 1;
+    _sum_imbalance = 0;
+    _max_imbalance = 1;
+    _runs = 0;
+}
+
+void load_balancer::init(size_t nfaces, size_t block_size, int nthreads, double alpha)
+{
+    if(block_size == 0)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Load balancer block size must be > 0"));
+    if(alpha <= 0 || alpha > 1)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Load balancer alpha must be in (0,1]"));
+
+    _nfaces = nfaces;
+    _block_size = block_size;
+    _alpha = alpha;
+    _measured = false;
+
+    size_t nblocks = nfaces / block_size + (nfaces % block_size == 0 ? 0 : 1);
+
+    // uniform cost gives an even split by faces
+    _block_cost.assign(nblocks, 1.0);
+    _range_start.assign(std::max(nthreads, 1) + 1, 0);
+    _range_time.assign(std::max(nthreads, 1), 0.0);
+
+    partition();
+}
+
+void load_balancer::partition()
+{
+    size_t nranges = _range_start.size() - 1;
+    size_t nblocks = _block_cost.size();
+
+    double total = 0;
+    for(auto c : _block_cost)
+        total += c;
+
+    double target = total / nranges;
+
+    // walk the blocks, cutting each time the running cost passes the next multiple of the target
+    double acc = 0;
+    size_t r = 1;
+    _range_start[0] = 0;
+    for(size_t b = 0; b < nblocks && r < nranges; ++b)
+    {
+        acc += _block_cost[b];
+
+        // cut before or after this block, whichever is closer to the target
+        while(r < nranges && acc >= target * r)
+        {
+            bool before = (acc - target * r) > _block_cost[b] / 2.0 && b > _range_start[r - 1];
+            _range_start[r] = before ? b : b + 1;
+            ++r;
+        }
+    }
+    for(; r <= nranges; ++r)
+        _range_start[r] = nblocks;
+}
+
+void load_balancer::update_stats()
+{
+    double max = 0;
+    double mean = 0;
+    for(auto t : _range_time)
+    {
+        max = std::max(max, t);
+        mean += t;
+    }
+    mean /= _range_time.size();
+
+    _last_imbalance = mean > 0 ? max / mean : 1;
+    _sum_imbalance += _last_imbalance;
+    _max_imbalance = std::max(_max_imbalance, _last_imbalance);
+    _runs++;
+}
+
+double load_balancer::last_imbalance()
+{
+    return _last_imbalance;
+}
+
+double load_balancer::mean_imbalance()
+{
+    return _runs > 0 ? _sum_imbalance / _runs : 1;
+}
+
+double load_balancer::max_imbalance()
+{
+    return _max_imbalance;
+}
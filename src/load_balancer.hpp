@@ -0,0 +1,147 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+//std includes
+#include <vector>
+#include <algorithm>
+
+//CHM includes
+#include "exception.hpp"
+#include "logger.hpp"
+#include "triangulation.hpp" // omp stubs
+#include "utility/profiler.hpp"
+
+/**
+ * Cost-aware partitioning of a data parallel loop over faces.
+ *
+ * Faces are grouped into fixed-size blocks and the wall time of every block is measured each time the loop runs. The
+ * per-block cost is smoothed over timesteps (exponential moving average) and used to cut the blocks into one contiguous
+ * range per thread such that each range has approximately equal cost. Contiguous ranges keep a thread on the same faces
+ * across timesteps and so preserve locality. Until the first measurement, the ranges are equal numbers of faces which
+ * is the same as a static schedule.
+ *
+ * The observed imbalance, max(thread time) / mean(thread time), is tracked so it can be reported.
+ */
+class load_balancer
+{
+  public:
+    load_balancer();
+
+    /**
+     * @param nfaces Number of faces in the loop
+     * @param block_size Faces per block
+     * @param nthreads Number of ranges to partition into, normally omp_get_max_threads()
+     * @param alpha Weight of the newest measurement in the cost average
+     */
+    void init(size_t nfaces, size_t block_size, int nthreads, double alpha = 0.5);
+
+    /**
+     * Runs f(i) for every face index i in [0, nfaces), then repartitions from the measured cost.
+     * Exceptions thrown by f are rethrown after the parallel region.
+     * @param f
+     */
+    template<typename F>
+    void run(F f);
+
+    /**
+     * Imbalance of the most recent run. 1 is perfectly balanced
+     * @return
+     */
+    double last_imbalance();
+
+    /**
+     * Mean imbalance over all runs
+     * @return
+     */
+    double mean_imbalance();
+
+    /**
+     * Worst imbalance over all runs
+     * @return
+     */
+    double max_imbalance();
+
+  private:
+    // recompute _range_start from _block_cost
+    void partition();
+    // update the imbalance stats from _range_time
+    void update_stats();
+
+    size_t _nfaces;
+    size_t _block_size;
+    double _alpha;
+    bool _measured;
+
+    std::vector<double> _block_cost; // ns
+    std::vector<size_t> _range_start; // block index each range starts at. Size is nranges + 1
+    std::vector<double> _range_time; // ns
+
+    double _last_imbalance;
+    double _sum_imbalance;
+    double _max_imbalance;
+    size_t _runs;
+};
+
+template<typename F>
+void load_balancer::run(F f)
+{
+    int nranges = static_cast<int>(_range_start.size()) - 1;
+    std::fill(_range_time.begin(), _range_time.end(), 0.0);
+
+    ompException oe;
+
+    #pragma omp parallel
+    {
+        // if we get fewer threads than expected, threads take additional ranges
+        int nthreads = omp_get_num_threads();
+        for (int r = omp_get_thread_num(); r < nranges; r += nthreads)
+        {
+            int64_t range_start = profiler::now();
+            for (size_t b = _range_start[r]; b < _range_start[r + 1]; ++b)
+            {
+                int64_t block_start = profiler::now();
+
+                size_t end = std::min(_nfaces, (b + 1) * _block_size);
+                oe.Run([&]
+                       {
+                           for (size_t i = b * _block_size; i < end; ++i)
+                           {
+                               f(i);
+                           }
+                       });
+
+                double cost = profiler::now() - block_start;
+                _block_cost[b] = _measured ? _alpha * cost + (1.0 - _alpha) * _block_cost[b] : cost;
+            }
+            _range_time[r] = profiler::now() - range_start;
+        }
+    }
+
+    oe.Rethrow();
+
+    _measured = true;
+    update_stats();
+    partition();
+}
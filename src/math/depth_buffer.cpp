@@ -0,0 +1,249 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "depth_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace math
+{
+    depth_buffer::depth_buffer(const std::vector<double>& x,
+                               const std::vector<double>& y,
+                               const std::vector<double>& z,
+                               const std::vector<std::array<int, 3>>& triangles,
+                               size_t resolution,
+                               size_t tile)
+        : _x(x), _y(y), _z(z), _triangles(triangles)
+    {
+        _xmin = std::numeric_limits<double>::max();
+        _ymin = std::numeric_limits<double>::max();
+        double xmax = std::numeric_limits<double>::lowest();
+        double ymax = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            _xmin = std::min(_xmin, x[i]);
+            _ymin = std::min(_ymin, y[i]);
+            xmax = std::max(xmax, x[i]);
+            ymax = std::max(ymax, y[i]);
+        }
+
+        resolution = std::max<size_t>(resolution, 1);
+        _pixel = std::max(xmax - _xmin, ymax - _ymin) / resolution;
+        if (!(_pixel > 0))
+            _pixel = 1;
+
+        _nx = static_cast<size_t>(std::ceil((xmax - _xmin) / _pixel)) + 1;
+        _ny = static_cast<size_t>(std::ceil((ymax - _ymin) / _pixel)) + 1;
+
+        _tile = std::max<size_t>(tile, 1);
+        _ntx = (_nx + _tile - 1) / _tile;
+        _nty = (_ny + _tile - 1) / _tile;
+    }
+
+    depth_buffer::raster_tri depth_buffer::setup(size_t t) const
+    {
+        raster_tri r;
+        const auto& tri = _triangles[t];
+
+        // pixel space, pixel centres are at integer + 0.5
+        double px[3], py[3], pz[3];
+        for (int i = 0; i < 3; i++)
+        {
+            px[i] = (_x[tri[i]] - _xmin) / _pixel;
+            py[i] = (_y[tri[i]] - _ymin) / _pixel;
+            pz[i] = _z[tri[i]];
+        }
+
+        double area = (px[1] - px[0]) * (py[2] - py[0]) - (px[2] - px[0]) * (py[1] - py[0]);
+        r.valid = area != 0 && std::isfinite(area);
+        if (!r.valid)
+            return r;
+
+        // orient the edge functions so the inside is positive whichever way the triangle winds
+        double s = area > 0 ? 1. : -1.;
+        for (int i = 0; i < 3; i++)
+        {
+            int j = (i + 1) % 3;
+            r.a[i] = s * (py[i] - py[j]);
+            r.b[i] = s * (px[j] - px[i]);
+            r.c[i] = s * (px[i] * py[j] - px[j] * py[i]);
+        }
+
+        // depth plane through the three vertices
+        r.za = ((pz[1] - pz[0]) * (py[2] - py[0]) - (pz[2] - pz[0]) * (py[1] - py[0])) / area;
+        r.zb = ((px[1] - px[0]) * (pz[2] - pz[0]) - (px[2] - px[0]) * (pz[1] - pz[0])) / area;
+        r.zc = pz[0] - r.za * px[0] - r.zb * py[0];
+
+        // pixels whose centre may be inside
+        r.col0 = std::max(0, static_cast<int>(std::ceil(std::min({px[0], px[1], px[2]}) - 0.5)));
+        r.col1 = std::min(static_cast<int>(_nx) - 1, static_cast<int>(std::floor(std::max({px[0], px[1], px[2]}) - 0.5)));
+        r.row0 = std::max(0, static_cast<int>(std::ceil(std::min({py[0], py[1], py[2]}) - 0.5)));
+        r.row1 = std::min(static_cast<int>(_ny) - 1, static_cast<int>(std::floor(std::max({py[0], py[1], py[2]}) - 0.5)));
+
+        return r;
+    }
+
+    template<typename F>
+    void depth_buffer::scan(const raster_tri& r, int col0, int col1, int row0, int row1, F f) const
+    {
+        for (int row = row0; row <= row1; row++)
+        {
+            double y = row + 0.5;
+            double x0 = col0 + 0.5;
+
+            // edge functions and depth at the start of the row, stepped by a per pixel
+            double w0 = r.a[0] * x0 + r.b[0] * y + r.c[0];
+            double w1 = r.a[1] * x0 + r.b[1] * y + r.c[1];
+            double w2 = r.a[2] * x0 + r.b[2] * y + r.c[2];
+            double d = r.za * x0 + r.zb * y + r.zc;
+
+            f(row, col0, col1, w0, w1, w2, d);
+        }
+    }
+
+    void depth_buffer::render()
+    {
+        size_t ntri = _triangles.size();
+        _depth.assign(_nx * _ny, -std::numeric_limits<float>::infinity());
+
+        _setup.resize(ntri);
+#pragma omp parallel for
+        for (size_t t = 0; t < ntri; t++)
+        {
+            _setup[t] = setup(t);
+        }
+
+        // bin the triangles to the tiles they overlap
+        size_t ntiles = _ntx * _nty;
+        _tile_start.assign(ntiles + 1, 0);
+        auto for_each_tile = [&](const raster_tri& r, size_t t, bool fill)
+        {
+            if (!r.valid || r.col0 > r.col1 || r.row0 > r.row1)
+                return;
+            for (size_t ty = r.row0 / _tile; ty <= r.row1 / _tile; ty++)
+                for (size_t tx = r.col0 / _tile; tx <= r.col1 / _tile; tx++)
+                {
+                    size_t k = ty * _ntx + tx;
+                    if (fill)
+                        _tile_tris[_tile_start[k]++] = t;
+                    else
+                        _tile_start[k + 1]++;
+                }
+        };
+
+        for (size_t t = 0; t < ntri; t++)
+            for_each_tile(_setup[t], t, false);
+        for (size_t k = 0; k < ntiles; k++)
+            _tile_start[k + 1] += _tile_start[k];
+
+        _tile_tris.resize(_tile_start[ntiles]);
+        for (size_t t = 0; t < ntri; t++)
+            for_each_tile(_setup[t], t, true);
+        // the fill advanced each start to the next tile's start
+        for (size_t k = ntiles; k > 0; k--)
+            _tile_start[k] = _tile_start[k - 1];
+        _tile_start[0] = 0;
+
+#pragma omp parallel for schedule(dynamic)
+        for (size_t k = 0; k < ntiles; k++)
+        {
+            int tcol0 = static_cast<int>((k % _ntx) * _tile);
+            int trow0 = static_cast<int>((k / _ntx) * _tile);
+            int tcol1 = std::min(static_cast<int>(_nx), tcol0 + static_cast<int>(_tile)) - 1;
+            int trow1 = std::min(static_cast<int>(_ny), trow0 + static_cast<int>(_tile)) - 1;
+
+            for (size_t i = _tile_start[k]; i < _tile_start[k + 1]; i++)
+            {
+                const auto& r = _setup[_tile_tris[i]];
+                scan(r, std::max(r.col0, tcol0), std::min(r.col1, tcol1), std::max(r.row0, trow0), std::min(r.row1, trow1),
+                     [&](int row, int c0, int c1, double w0, double w1, double w2, double d)
+                     {
+                         float* out = &_depth[row * _nx];
+                         double a0 = r.a[0], a1 = r.a[1], a2 = r.a[2], za = r.za;
+#pragma omp simd
+                         for (int col = c0; col <= c1; col++)
+                         {
+                             double i = col - c0;
+                             bool inside = (w0 + a0 * i >= 0) & (w1 + a1 * i >= 0) & (w2 + a2 * i >= 0);
+                             float depth = static_cast<float>(d + za * i);
+                             out[col] = (inside && depth > out[col]) ? depth : out[col];
+                         }
+                     });
+            }
+        }
+    }
+
+    std::vector<double> depth_buffer::occluded_fraction(double tolerance) const
+    {
+        size_t ntri = _triangles.size();
+        std::vector<double> fraction(ntri, 0.);
+
+#pragma omp parallel for
+        for (size_t t = 0; t < ntri; t++)
+        {
+            const auto& r = _setup[t];
+            if (!r.valid)
+                continue;
+
+            size_t covered = 0;
+            size_t hidden = 0;
+            scan(r, r.col0, r.col1, r.row0, r.row1,
+                 [&](int row, int c0, int c1, double w0, double w1, double w2, double d)
+                 {
+                     const float* in = &_depth[row * _nx];
+                     for (int col = c0; col <= c1; col++)
+                     {
+                         double i = col - c0;
+                         if (w0 + r.a[0] * i >= 0 && w1 + r.a[1] * i >= 0 && w2 + r.a[2] * i >= 0)
+                         {
+                             covered++;
+                             if (in[col] > d + r.za * i + tolerance)
+                                 hidden++;
+                         }
+                     }
+                 });
+
+            if (covered == 0)
+            {
+                // smaller than a pixel, sample the centroid
+                const auto& tri = _triangles[t];
+                double cx = ((_x[tri[0]] + _x[tri[1]] + _x[tri[2]]) / 3. - _xmin) / _pixel;
+                double cy = ((_y[tri[0]] + _y[tri[1]] + _y[tri[2]]) / 3. - _ymin) / _pixel;
+                double cz = (_z[tri[0]] + _z[tri[1]] + _z[tri[2]]) / 3.;
+                size_t col = std::min(_nx - 1, static_cast<size_t>(std::max(0., cx)));
+                size_t row = std::min(_ny - 1, static_cast<size_t>(std::max(0., cy)));
+
+                fraction[t] = _depth[row * _nx + col] > cz + tolerance ? 1. : 0.;
+            }
+            else
+            {
+                fraction[t] = static_cast<double>(hidden) / covered;
+            }
+        }
+
+        return fraction;
+    }
+}
@@ -0,0 +1,119 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace math
+{
+    /**
+     * CPU depth buffer (z-buffer) for triangles already projected into the view plane: x, y in the plane and z towards
+     * the viewer, so larger z is closer. Used to find the parts of a mesh hidden from a direction, e.g., the sun, in
+     * O(triangles + pixels) rather than by testing triangles against each other.
+     *
+     * The buffer is split into square tiles which are rendered in parallel, each by one thread, so no pixel is written
+     * concurrently. Rows of a tile are scanned with incrementally evaluated edge functions in a loop the compiler can
+     * vectorize.
+     */
+    class depth_buffer
+    {
+      public:
+        /**
+         * @param x Projected vertex coordinates
+         * @param y
+         * @param z Depth, larger is closer to the viewer
+         * @param triangles Vertex indices of each triangle
+         * @param resolution Number of pixels along the longer side of the bounding box of the vertices
+         * @param tile Size of the square tiles [pixels]
+         */
+        depth_buffer(const std::vector<double>& x,
+                     const std::vector<double>& y,
+                     const std::vector<double>& z,
+                     const std::vector<std::array<int, 3>>& triangles,
+                     size_t resolution,
+                     size_t tile = 64);
+
+        /**
+         * Renders all the triangles, keeping the closest depth in each pixel
+         */
+        void render();
+
+        /**
+         * For each triangle, the fraction of the pixels it covers in which another triangle is closer to the viewer
+         * by more than tolerance. Triangles smaller than a pixel are sampled at their centroid.
+         * @param tolerance Depth tolerance, in the units of z
+         * @return
+         */
+        std::vector<double> occluded_fraction(double tolerance) const;
+
+        size_t width() const { return _nx; }
+        size_t height() const { return _ny; }
+
+        /// Size of a pixel in the units of x and y
+        double pixel_size() const { return _pixel; }
+
+        /// Depth of a pixel, -inf if no triangle covers it
+        float depth(size_t col, size_t row) const { return _depth[row * _nx + col]; }
+
+      private:
+        // setup of a triangle for scan conversion
+        struct raster_tri
+        {
+            // edge functions w = a*x + b*y + c, >= 0 inside
+            double a[3], b[3], c[3];
+            // depth plane z = za*x + zb*y + zc
+            double za, zb, zc;
+            // pixel bounds (inclusive)
+            int col0, col1, row0, row1;
+            bool valid;
+        };
+
+        raster_tri setup(size_t t) const;
+
+        // calls f(row, col0, col1, w0, w1, w2, depth) for each row of [col0,col1]x[row0,row1] with the edge functions and
+        // depth at the first pixel centre of the row, to be stepped by a[i] and za per pixel
+        template<typename F>
+        void scan(const raster_tri& r, int col0, int col1, int row0, int row1, F f) const;
+
+        const std::vector<double>& _x;
+        const std::vector<double>& _y;
+        const std::vector<double>& _z;
+        const std::vector<std::array<int, 3>>& _triangles;
+
+        double _xmin, _ymin;
+        double _pixel;
+        size_t _nx, _ny;
+        size_t _tile, _ntx, _nty;
+
+        std::vector<float> _depth;
+        std::vector<raster_tri> _setup;
+
+        // triangles overlapping each tile, CSR
+        std::vector<size_t> _tile_start;
+        std::vector<size_t> _tile_tris;
+    };
+}
@@ -0,0 +1,199 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "expint.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace math
+{
+    namespace
+    {
+        const size_t nterms = 22;
+
+        // Ein(t) on [0,4], in x = t/2 - 1. Converged by the 16th term, zero padded to the length of the other series
+        const double ein_low[nterms] = {
+            1.1564687991792746,
+            0.95244477639478264,
+            -0.16771406564372018,
+            0.030455873133010628,
+            -0.0050136108368622045,
+            0.00073283807728592384,
+            -9.5258061215848459e-05,
+            1.1089333245379327e-05,
+            -1.1655906076234646e-06,
+            1.1148325590061843e-07,
+            -9.7717447393480779e-09,
+            7.8990132053746559e-10,
+            -5.9215659181192193e-11,
+            4.1375824079327146e-12,
+            -2.7057441635926896e-13,
+            1.6887729529644392e-14,
+            0., 0., 0., 0., 0., 0.};
+
+        // t exp(t) E1(t) on (4,inf), in x = 8/t - 1
+        const double e1_high[nterms] = {
+            0.90535409996234917,
+            -0.086481178552598653,
+            0.0072241015437465436,
+            -0.00080975594575562518,
+            0.00010999134432637942,
+            -1.7173329989531712e-05,
+            2.9856275143875878e-06,
+            -5.6596491453095557e-07,
+            1.1526808414272517e-07,
+            -2.4950304281985397e-08,
+            5.6923242003152242e-09,
+            -1.3599576072463302e-09,
+            3.3846634540890151e-10,
+            -8.7378001738609553e-11,
+            2.3315686359218187e-11,
+            -6.4107874882444195e-12,
+            1.8123449797991254e-12,
+            -5.2574235410442283e-13,
+            1.5576887718928456e-13,
+            -4.7416552442771436e-14,
+            1.4061332633240135e-14,
+            -4.6361709862970549e-15};
+
+        // The high series needs log(t) and exp(-t). libm's aren't vectorized without -ffast-math, so these are
+        // branch free versions for the range used. Doubles are split with bit operations instead of int conversions,
+        // which also vectorize.
+        inline uint64_t as_bits(double d)
+        {
+            uint64_t u;
+            std::memcpy(&u, &d, sizeof(d));
+            return u;
+        }
+
+        inline double from_bits(uint64_t u)
+        {
+            double d;
+            std::memcpy(&d, &u, sizeof(d));
+            return d;
+        }
+
+        // fdlibm's split of log(2), n * ln2_hi is exact for |n| < 2^11
+        const double ln2_hi = 6.93147180369123816490e-01;
+        const double ln2_lo = 1.90821492927058770002e-10;
+
+        // exp(u) for u in [-700, 0]
+        inline double exp_neg(double u)
+        {
+            // u = n log(2) + r, |r| <= log(2)/2. Adding 1.5*2^52 rounds to an integer held in the low mantissa bits
+            const double shift = 6755399441055744.0;
+            double k = u * 1.4426950408889634074 + shift;
+            double n = k - shift;
+            double r = (u - n * ln2_hi) - n * ln2_lo;
+
+            // Taylor series, the truncation is below 2e-17 relative
+            double p = 1.0 / 39916800.0;
+            p = p * r + 1.0 / 3628800.0;
+            p = p * r + 1.0 / 362880.0;
+            p = p * r + 1.0 / 40320.0;
+            p = p * r + 1.0 / 5040.0;
+            p = p * r + 1.0 / 720.0;
+            p = p * r + 1.0 / 120.0;
+            p = p * r + 1.0 / 24.0;
+            p = p * r + 1.0 / 6.0;
+            p = p * r + 0.5;
+            p = p * r + 1.0;
+            p = p * r + 1.0;
+
+            // 2^n from the low bits of k
+            return p * from_bits((as_bits(k) + 1023) << 52);
+        }
+
+        // log(t) for finite, normal t > 0
+        inline double log_pos(double t)
+        {
+            // t = m 2^e with m in [sqrt(2)/2, sqrt(2))
+            uint64_t bits = as_bits(t);
+            double e = from_bits((bits >> 52) | 0x4330000000000000ULL) - 4503599627370496.0 - 1023.0;
+            double m = from_bits((bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+
+            bool big = m > 1.4142135623730951;
+            m = big ? 0.5 * m : m;
+            e = big ? e + 1.0 : e;
+
+            // log(m) = 2 atanh(s), |s| <= 0.172 so the truncation is below 1e-17
+            double s = (m - 1.0) / (m + 1.0);
+            double s2 = s * s;
+            double p = 1.0 / 21.0;
+            p = p * s2 + 1.0 / 19.0;
+            p = p * s2 + 1.0 / 17.0;
+            p = p * s2 + 1.0 / 15.0;
+            p = p * s2 + 1.0 / 13.0;
+            p = p * s2 + 1.0 / 11.0;
+            p = p * s2 + 1.0 / 9.0;
+            p = p * s2 + 1.0 / 7.0;
+            p = p * s2 + 1.0 / 5.0;
+            p = p * s2 + 1.0 / 3.0;
+            p = p * s2 + 1.0;
+
+            return e * ln2_hi + (e * ln2_lo + 2.0 * s * p);
+        }
+
+        inline double ein_approx(double t)
+        {
+            bool low = t <= 4.0;
+
+            // keep the unused branch finite, it is computed and then discarded
+            double th = low ? 8.0 : t;
+            double x = low ? 0.5 * t - 1.0 : 8.0 / th - 1.0;
+
+            // Clenshaw recurrence, picking the series per value rather than branching. Unrolled, as the loop over
+            // the values won't vectorize with an inner loop
+            double b1 = 0., b2 = 0.;
+#pragma GCC unroll 32
+            for (size_t k = nterms - 1; k >= 1; k--)
+            {
+                double a = low ? ein_low[k] : e1_high[k];
+                double b0 = 2.0 * x * b1 - b2 + a;
+                b2 = b1;
+                b1 = b0;
+            }
+            double s = x * b1 - b2 + (low ? ein_low[0] : e1_high[0]);
+
+            // E1(t) < 1e-19 past 40
+            double e1 = th > 40.0 ? 0.0 : exp_neg(-th) / th * s;
+            double high = log_pos(th) + euler_gamma + e1;
+
+            return low ? s : high;
+        }
+    }
+
+    double ein(double t)
+    {
+        return ein_approx(t);
+    }
+
+    void ein(const double* t, double* out, size_t n)
+    {
+#pragma omp simd
+        for (size_t i = 0; i < n; i++)
+            out[i] = ein_approx(t[i]);
+    }
+}
@@ -0,0 +1,55 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <cstddef>
+
+namespace math
+{
+    /**
+     * Entire exponential integral Ein(t) = log(t) + gamma + E1(t), t >= 0, where gamma is Euler's constant.
+     *
+     * This is the thin plate spline with tension kernel. Ein is smooth at 0, unlike its log and E1 parts, so it is
+     * approximated directly by a Chebyshev series on [0,4], and above that as log(t) + gamma + exp(-t)/t * h(8/t - 1)
+     * with h a Chebyshev series. The absolute error against GSL is below 4e-15 over the whole range, and at t = 0 it
+     * returns the limit (0, to the same error) rather than the nan of log(0) + E1(0).
+     *
+     * The series are the same length and evaluated branch free so the array version vectorizes.
+     * @param t
+     * @return
+     */
+    double ein(double t);
+
+    /**
+     * Ein for n values
+     * @param t
+     * @param out May alias t
+     * @param n
+     */
+    void ein(const double* t, double* out, size_t n);
+
+    /// Euler's constant
+    constexpr double euler_gamma = 0.57721566490153286061;
+}
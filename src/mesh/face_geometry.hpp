@@ -0,0 +1,83 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Per-face geometry, computed once when the mesh is loaded and held in flat arrays (structure of arrays) by the
+ * triangulation. A face's values are at its cell_local_id: rows [0, size_faces()) are the local faces and the rest are
+ * the ghost neighbors, the same rows as the variable store. Neighbor stencils can then read their geometry from
+ * contiguous memory rather than through the face's lazily computed CGAL members.
+ *
+ *  auto& geo = domain->geometry();
+ *  auto row = face->cell_local_id;
+ *  double dz = geo.z[row] - geo.z[geo.neighbor[row][j]];
+ */
+struct face_geometry
+{
+    /// Number of rows
+    size_t size() const { return x.size(); }
+
+    void resize(size_t n)
+    {
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        nx.resize(n);
+        ny.resize(n);
+        nz.resize(n);
+        slope.resize(n);
+        aspect.resize(n);
+        area.resize(n);
+        edge_length.resize(n);
+        edge_nx.resize(n);
+        edge_ny.resize(n);
+        neighbor.resize(n);
+        neighbor_distance.resize(n);
+    }
+
+    // centroid
+    std::vector<double> x, y, z;
+
+    // unit normal
+    std::vector<double> nx, ny, nz;
+
+    std::vector<double> slope;  // [rad]
+    std::vector<double> aspect; // North = 0, CW [rad]
+    std::vector<double> area;   // [m^2]
+
+    // Per edge, numbered as face::edge
+    std::vector<std::array<double, 3>> edge_length;
+    std::vector<std::array<double, 3>> edge_nx, edge_ny; // outward unit normal, as face::edge_unit_normal
+
+    // Row of the neighbor across each edge, -1 if there is no neighbor or it isn't held by this process
+    std::vector<std::array<int, 3>> neighbor;
+
+    // Distance between the centres of the face and each neighbor, 0 if there is no neighbor
+    std::vector<std::array<double, 3>> neighbor_distance;
+};
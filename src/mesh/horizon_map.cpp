@@ -0,0 +1,77 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#include "horizon_map.hpp"
+
+#include <algorithm>
+
+constexpr double horizon_map::scale;
+
+horizon_map::horizon_map(size_t rows, size_t sectors, double max_distance)
+{
+    _rows = rows;
+    _sectors = sectors;
+    _max_distance = max_distance;
+    _angles.assign(rows * sectors, 0);
+}
+
+void horizon_map::set(size_t row, size_t sector, double angle)
+{
+    angle = std::min(std::max(angle, 0.0), M_PI_2);
+    _angles[row * _sectors + sector] = static_cast<uint16_t>(std::lround(angle / scale));
+}
+
+double horizon_map::angle_at(size_t row, double azimuth) const
+{
+    double x = std::fmod(azimuth, 360.);
+    if (x < 0)
+        x += 360.;
+    x = x / 360. * _sectors;
+
+    size_t k0 = static_cast<size_t>(x) % _sectors;
+    size_t k1 = (k0 + 1) % _sectors;
+    double w = x - std::floor(x);
+
+    return (1. - w) * angle(row, k0) + w * angle(row, k1);
+}
+
+double horizon_map::svf(size_t row, double slope, double aspect) const
+{
+    double cosSlope = cos(slope);
+    double sinSlope = sin(slope);
+
+    double svf = 0.;
+    for (size_t k = 0; k < _sectors; k++)
+    {
+        double phi = angle(row, k);
+        double cosPhi = cos(phi);
+        double sinPhi = sin(phi);
+        double azi = k * 2. * M_PI / _sectors;
+
+        svf += cosSlope * cosPhi * cosPhi +
+               sinSlope * cos(azi - aspect) * (M_PI_2 - phi - sinPhi * cosPhi);
+    }
+
+    return svf / _sectors;
+}
@@ -0,0 +1,86 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Horizon elevation angle of each face in a fixed number of azimuth sectors, sector k being centred on the bearing
+ * k * 360 / sectors(). Built once by triangulation::horizon as the terrain is static, after which shading is a table
+ * lookup and the sky view factor follows from the same angles.
+ *
+ * The angles are quantized to 16 bits over [0, pi/2] (~0.0014 degree resolution) and stored row-major per face.
+ * Rows are the faces' cell_local_id.
+ */
+class horizon_map
+{
+  public:
+    horizon_map(size_t rows, size_t sectors, double max_distance);
+
+    size_t rows() const { return _rows; }
+    size_t sectors() const { return _sectors; }
+
+    /// Search distance the horizons were computed over [m]
+    double max_distance() const { return _max_distance; }
+
+    /// Horizon angle of a sector [rad]
+    double angle(size_t row, size_t sector) const
+    {
+        return _angles[row * _sectors + sector] * scale;
+    }
+
+    void set(size_t row, size_t sector, double angle);
+
+    /**
+     * Horizon angle at any azimuth, linearly interpolated between the two bracketing sectors
+     * @param row
+     * @param azimuth Degrees, CW from north
+     * @return [rad]
+     */
+    double angle_at(size_t row, double azimuth) const;
+
+    /**
+     * Sky view factor of a face from its horizons, after Dozier and Frew (1990)
+     * @param row
+     * @param slope [rad]
+     * @param aspect [rad]
+     * @return
+     */
+    double svf(size_t row, double slope, double aspect) const;
+
+    /// The quantized angles, for (de)serialization
+    std::vector<uint16_t>& data() { return _angles; }
+
+  private:
+    // radians per quantization step
+    static constexpr double scale = M_PI_2 / 65535.;
+
+    size_t _rows;
+    size_t _sectors;
+    double _max_distance;
+    std::vector<uint16_t> _angles;
+};
@@ -0,0 +1,213 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "mesh_cache.hpp"
+#include "utility/wyhash.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mesh_cache
+{
+    namespace
+    {
+        const char magic[8] = {'C', 'H', 'M', 'M', 'E', 'S', 'H', '\0'};
+
+        // magic, version, flags and input hash, each padded to 8 bytes
+        const size_t header_size = 32;
+
+        size_t padded(size_t n)
+        {
+            return (n + 7) & ~size_t(7);
+        }
+    }
+
+    uint64_t hash_files(const std::vector<std::string>& files, uint64_t seed)
+    {
+        uint64_t h = seed;
+        std::vector<char> buffer(1 << 20);
+        for (auto& f : files)
+        {
+            std::ifstream in(f, std::ios::binary);
+            if (!in)
+                BOOST_THROW_EXCEPTION(file_read_error() << errstr_info("Unable to open " + f + " to hash it"));
+
+            h = hash_string(f, h);
+            while (in)
+            {
+                in.read(buffer.data(), buffer.size());
+                auto n = in.gcount();
+                if (n > 0)
+                    h = wyhash(buffer.data(), n, h);
+            }
+        }
+        return h;
+    }
+
+    uint64_t hash_string(const std::string& s, uint64_t seed)
+    {
+        return wyhash(s.data(), s.size(), seed);
+    }
+
+    writer::writer(const std::string& path, uint64_t input_hash, uint32_t flags)
+    {
+        _path = path;
+        _tmp_path = path + ".tmp";
+        _closed = false;
+
+        _out.open(_tmp_path, std::ios::binary | std::ios::trunc);
+        if (!_out)
+            BOOST_THROW_EXCEPTION(file_write_error() << errstr_info("Unable to write mesh cache " + _tmp_path));
+
+        write_bytes(magic, sizeof(magic));
+        write<uint32_t>(version);
+        write<uint32_t>(flags);
+        write<uint64_t>(input_hash);
+    }
+
+    writer::~writer()
+    {
+        if (!_closed)
+        {
+            // abandoned part way, don't leave a partial file behind
+            _out.close();
+            std::remove(_tmp_path.c_str());
+        }
+    }
+
+    void writer::write_bytes(const void* data, size_t n)
+    {
+        static const char zeros[8] = {0};
+        _out.write(static_cast<const char*>(data), n);
+        _out.write(zeros, padded(n) - n);
+    }
+
+    void writer::write_string(const std::string& s)
+    {
+        write_array(s.data(), s.size());
+    }
+
+    void writer::close()
+    {
+        _out.close();
+        if (!_out || std::rename(_tmp_path.c_str(), _path.c_str()) != 0)
+        {
+            std::remove(_tmp_path.c_str());
+            _closed = true;
+            BOOST_THROW_EXCEPTION(file_write_error() << errstr_info("Unable to write mesh cache " + _path));
+        }
+        _closed = true;
+    }
+
+    reader::reader()
+    {
+        _data = nullptr;
+        _size = 0;
+        _pos = 0;
+        _fd = -1;
+        _flags = 0;
+    }
+
+    reader::~reader()
+    {
+        close();
+    }
+
+    bool reader::open(const std::string& path, uint64_t input_hash)
+    {
+        close();
+
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if (_fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(_fd, &st) != 0 || static_cast<size_t>(st.st_size) < header_size)
+        {
+            close();
+            return false;
+        }
+        _size = st.st_size;
+
+        void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (p == MAP_FAILED)
+        {
+            _size = 0;
+            close();
+            return false;
+        }
+        _data = static_cast<const char*>(p);
+        _pos = 0;
+
+        if (std::memcmp(take(sizeof(magic)), magic, sizeof(magic)) != 0 ||
+            read<uint32_t>() != version)
+        {
+            close();
+            return false;
+        }
+        uint32_t flags = read<uint32_t>();
+
+        if (read<uint64_t>() != input_hash)
+        {
+            close();
+            return false;
+        }
+        _flags = flags;
+
+        return true;
+    }
+
+    const char* reader::take(size_t n)
+    {
+        if (_pos + n > _size)
+            BOOST_THROW_EXCEPTION(file_read_error() << errstr_info("Mesh cache is truncated"));
+
+        const char* p = _data + _pos;
+        _pos += padded(n);
+        return p;
+    }
+
+    std::string reader::read_string()
+    {
+        size_t n;
+        const char* p = read_array<char>(n);
+        return std::string(p, n);
+    }
+
+    void reader::close()
+    {
+        if (_data)
+            munmap(const_cast<char*>(_data), _size);
+        if (_fd >= 0)
+            ::close(_fd);
+
+        _data = nullptr;
+        _size = 0;
+        _pos = 0;
+        _fd = -1;
+        _flags = 0;
+    }
+}
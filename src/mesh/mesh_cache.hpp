@@ -0,0 +1,176 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "exception.hpp"
+
+/**
+ * Flat binary file used to cache a fully initialized mesh between runs.
+ *
+ * The file is a fixed header (magic, format version, hash of the inputs) followed by a sequence of values, strings and
+ * arrays, each padded to 8 bytes so that arrays can be used in place from the memory map. The layout of the sections is
+ * defined by the writer and reader (triangulation::write_cache / from_cache), which must be kept in sync; bump
+ * mesh_cache::version whenever it changes so old files are rebuilt rather than misread.
+ */
+namespace mesh_cache
+{
+    /// Increment when the layout of the cache changes
+    const uint32_t version = 3;
+
+    /// Header flag set if the cached mesh is geographic. It is in the header so the caller can set up the distance
+    /// functions, which loading the mesh needs, before the cache is read.
+    const uint32_t flag_geographic = 1;
+
+    /**
+     * Hash of the contents of a set of files, e.g., the mesh and its parameter files, used to detect a stale cache.
+     * @param files
+     * @param seed Mixes in anything else the cache depends on, e.g., options
+     * @return
+     */
+    uint64_t hash_files(const std::vector<std::string>& files, uint64_t seed);
+
+    /**
+     * Hash of a string, for use as a seed
+     */
+    uint64_t hash_string(const std::string& s, uint64_t seed = 0);
+
+    class writer
+    {
+      public:
+        /**
+         * Starts writing a cache. The data is written to a temporary file which replaces path on close() so a partial
+         * file is never read.
+         * @param flags Stored in the header, e.g., flag_geographic
+         */
+        writer(const std::string& path, uint64_t input_hash, uint32_t flags = 0);
+        ~writer();
+
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be cached");
+            write_bytes(&value, sizeof(T));
+        }
+
+        template<typename T>
+        void write_array(const T* data, size_t n)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be cached");
+            write<uint64_t>(n);
+            write_bytes(data, n * sizeof(T));
+        }
+
+        template<typename T>
+        void write_array(const std::vector<T>& data)
+        {
+            write_array(data.data(), data.size());
+        }
+
+        void write_string(const std::string& s);
+
+        /**
+         * Finishes the file and moves it into place
+         */
+        void close();
+
+      private:
+        void write_bytes(const void* data, size_t n);
+
+        std::string _path;
+        std::string _tmp_path;
+        std::ofstream _out;
+        bool _closed;
+    };
+
+    class reader
+    {
+      public:
+        reader();
+        ~reader();
+
+        /**
+         * Maps a cache file. Returns false, without throwing, if the file doesn't exist, isn't a cache of this version
+         * or was built from different inputs.
+         * @param path
+         * @param input_hash
+         * @return
+         */
+        bool open(const std::string& path, uint64_t input_hash);
+
+        /**
+         * The header flags of the open cache
+         * @return
+         */
+        uint32_t flags() const { return _flags; }
+
+        template<typename T>
+        T read()
+        {
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        /**
+         * Returns a pointer to an array in the mapped file. Valid while the reader is open.
+         * @param n Number of elements
+         * @return
+         */
+        template<typename T>
+        const T* read_array(size_t& n)
+        {
+            n = read<uint64_t>();
+            return reinterpret_cast<const T*>(take(n * sizeof(T)));
+        }
+
+        template<typename T>
+        std::vector<T> read_vector()
+        {
+            size_t n;
+            const T* p = read_array<T>(n);
+            return std::vector<T>(p, p + n);
+        }
+
+        std::string read_string();
+
+        void close();
+
+      private:
+        // returns the current position and advances past n bytes (padded). Throws if past the end of the file
+        const char* take(size_t n);
+
+        const char* _data;
+        size_t _size;
+        size_t _pos;
+        int _fd;
+        uint32_t _flags;
+    };
+}
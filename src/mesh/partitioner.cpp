@@ -0,0 +1,338 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "partitioner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <numeric>
+
+#ifdef USE_METIS
+#include <metis.h>
+#endif
+
+namespace partitioner
+{
+    method from_string(const std::string& name)
+    {
+        if(name == "block")
+            return method::block;
+        if(name == "bisection")
+            return method::bisection;
+        if(name == "metis")
+        {
+#ifdef USE_METIS
+            return method::metis;
+#else
+            BOOST_THROW_EXCEPTION(config_error() << errstr_info("The metis partitioner was requested but CHM was not built with METIS."));
+#endif
+        }
+
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown partitioner " + name + ". Options are block, bisection or metis."));
+    }
+
+    namespace
+    {
+        // Allowed overshoot of a side's target weight during refinement
+        const double balance_tolerance = 1.02;
+        const int refinement_passes = 4;
+
+        /**
+         * State shared by the recursive bisections. region[v] is the sub-graph v currently belongs to; a bisection only
+         * sees the edges between vertices with the same region.
+         */
+        struct bisector
+        {
+            const graph& g;
+            std::vector<int>& part;
+            std::vector<int> region;
+            std::vector<long> dist;
+            int next_region;
+
+            bisector(const graph& graph, std::vector<int>& p) :
+                g(graph), part(p), region(graph.size(), 0), dist(graph.size(), -1), next_region(1) {}
+
+            // breadth first search over the region from start. Returns the vertices in visit order
+            std::vector<size_t> bfs(const std::vector<size_t>& vertices, size_t start, int r)
+            {
+                for(auto v : vertices)
+                    dist[v] = -1;
+
+                std::vector<size_t> order;
+                order.reserve(vertices.size());
+
+                // the region may be disconnected, so restart from any unvisited vertex
+                size_t next_unvisited = 0;
+                size_t seed = start;
+                while(order.size() < vertices.size())
+                {
+                    std::deque<size_t> queue;
+                    dist[seed] = 0;
+                    queue.push_back(seed);
+                    while(!queue.empty())
+                    {
+                        size_t v = queue.front();
+                        queue.pop_front();
+                        order.push_back(v);
+
+                        for(size_t e = g.xadj[v]; e < g.xadj[v + 1]; e++)
+                        {
+                            size_t u = g.adjncy[e];
+                            if(region[u] == r && dist[u] < 0)
+                            {
+                                dist[u] = dist[v] + 1;
+                                queue.push_back(u);
+                            }
+                        }
+                    }
+
+                    while(next_unvisited < vertices.size() && dist[vertices[next_unvisited]] >= 0)
+                        next_unvisited++;
+                    if(next_unvisited < vertices.size())
+                        seed = vertices[next_unvisited];
+                }
+                return order;
+            }
+
+            void bisect(const std::vector<size_t>& vertices, int r, int first_part, int nparts)
+            {
+                if(nparts == 1 || vertices.size() <= 1)
+                {
+                    for(auto v : vertices)
+                        part[v] = first_part;
+                    return;
+                }
+
+                int nleft = nparts / 2;
+                double total = 0;
+                for(auto v : vertices)
+                    total += g.w(v);
+                double target = total * nleft / nparts;
+
+                std::vector<size_t> order;
+                if(!g.xy.empty())
+                {
+                    // straight cut across the longest side of the region's bounding box
+                    double min_x = g.xy[vertices[0]][0], max_x = min_x;
+                    double min_y = g.xy[vertices[0]][1], max_y = min_y;
+                    for(auto v : vertices)
+                    {
+                        min_x = std::min(min_x, g.xy[v][0]);
+                        max_x = std::max(max_x, g.xy[v][0]);
+                        min_y = std::min(min_y, g.xy[v][1]);
+                        max_y = std::max(max_y, g.xy[v][1]);
+                    }
+                    int axis = (max_x - min_x) >= (max_y - min_y) ? 0 : 1;
+
+                    order = vertices;
+                    std::stable_sort(order.begin(), order.end(),
+                                     [this, axis](size_t a, size_t b) { return g.xy[a][axis] < g.xy[b][axis]; });
+                }
+                else
+                {
+                    // the last vertex reached from an arbitrary start is a pseudo-peripheral vertex. Growing from it
+                    // gives a front that sweeps across the region
+                    order = bfs(vertices, vertices[0], r);
+                    order = bfs(vertices, order.back(), r);
+                }
+
+                int left = next_region++;
+                int right = next_region++;
+
+                double left_weight = 0;
+                for(auto v : order)
+                {
+                    if(left_weight < target)
+                    {
+                        region[v] = left;
+                        left_weight += g.w(v);
+                    }
+                    else
+                    {
+                        region[v] = right;
+                    }
+                }
+
+                refine(vertices, left, right, left_weight, total, target);
+
+                std::vector<size_t> lv, rv;
+                for(auto v : vertices)
+                {
+                    if(region[v] == left)
+                        lv.push_back(v);
+                    else
+                        rv.push_back(v);
+                }
+
+                bisect(lv, left, first_part, nleft);
+                bisect(rv, right, first_part + nleft, nparts - nleft);
+            }
+
+            // greedily move vertices across the bisection when it lowers the cut and keeps both sides within tolerance
+            void refine(const std::vector<size_t>& vertices, int left, int right, double& left_weight, double total, double target)
+            {
+                double max_left = target * balance_tolerance;
+                double max_right = (total - target) * balance_tolerance;
+
+                for(int pass = 0; pass < refinement_passes; pass++)
+                {
+                    size_t moved = 0;
+                    for(auto v : vertices)
+                    {
+                        int from = region[v];
+                        int to = from == left ? right : left;
+
+                        long internal = 0, external = 0;
+                        for(size_t e = g.xadj[v]; e < g.xadj[v + 1]; e++)
+                        {
+                            int ru = region[g.adjncy[e]];
+                            if(ru == from)
+                                internal++;
+                            else if(ru == to)
+                                external++;
+                        }
+
+                        if(external <= internal)
+                            continue;
+
+                        double w = g.w(v);
+                        double new_left = from == left ? left_weight - w : left_weight + w;
+                        if(new_left > max_left || total - new_left > max_right)
+                            continue;
+
+                        region[v] = to;
+                        left_weight = new_left;
+                        moved++;
+                    }
+
+                    if(moved == 0)
+                        break;
+                }
+            }
+        };
+
+#ifdef USE_METIS
+        std::vector<int> metis(const graph& g, int nparts)
+        {
+            idx_t nvtxs = static_cast<idx_t>(g.size());
+            idx_t ncon = 1;
+            idx_t np = nparts;
+            idx_t objval = 0;
+
+            std::vector<idx_t> xadj(g.xadj.begin(), g.xadj.end());
+            std::vector<idx_t> adjncy(g.adjncy.begin(), g.adjncy.end());
+
+            // METIS needs integer weights, so scale them relative to the mean
+            std::vector<idx_t> vwgt;
+            if(!g.weight.empty())
+            {
+                double mean = std::accumulate(g.weight.begin(), g.weight.end(), 0.0) / g.weight.size();
+                vwgt.resize(g.size());
+                for(size_t v = 0; v < g.size(); v++)
+                    vwgt[v] = std::max<idx_t>(1, static_cast<idx_t>(std::lround(100.0 * g.weight[v] / mean)));
+            }
+
+            std::vector<idx_t> p(g.size());
+            int ret = METIS_PartGraphKway(&nvtxs, &ncon, xadj.data(), adjncy.data(),
+                                          vwgt.empty() ? nullptr : vwgt.data(), nullptr, nullptr,
+                                          &np, nullptr, nullptr, nullptr, &objval, p.data());
+            if(ret != METIS_OK)
+                BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("METIS partitioning failed with code " + std::to_string(ret)));
+
+            return std::vector<int>(p.begin(), p.end());
+        }
+#endif
+    }
+
+    std::vector<int> partition(const graph& g, int nparts, method m)
+    {
+        if(nparts < 1)
+            BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Cannot partition into " + std::to_string(nparts) + " parts."));
+
+        std::vector<int> part(g.size(), 0);
+        if(nparts == 1 || g.size() == 0)
+            return part;
+
+        switch(m)
+        {
+            case method::block:
+            {
+                // same as the original partitioning: the first size % nparts parts get one extra vertex
+                size_t n = g.size() / nparts;
+                size_t extra = g.size() % nparts;
+                size_t v = 0;
+                for(int p = 0; p < nparts; p++)
+                {
+                    size_t count = n + (static_cast<size_t>(p) < extra ? 1 : 0);
+                    for(size_t i = 0; i < count; i++)
+                        part[v++] = p;
+                }
+                break;
+            }
+            case method::bisection:
+            {
+                std::vector<size_t> vertices(g.size());
+                std::iota(vertices.begin(), vertices.end(), 0);
+                bisector b(g, part);
+                b.bisect(vertices, 0, 0, nparts);
+                break;
+            }
+            case method::metis:
+            {
+#ifdef USE_METIS
+                part = metis(g, nparts);
+#else
+                BOOST_THROW_EXCEPTION(config_error() << errstr_info("The metis partitioner was requested but CHM was not built with METIS."));
+#endif
+                break;
+            }
+        }
+
+        return part;
+    }
+
+    size_t edge_cut(const graph& g, const std::vector<int>& part)
+    {
+        size_t cut = 0;
+        for(size_t v = 0; v < g.size(); v++)
+        {
+            for(size_t e = g.xadj[v]; e < g.xadj[v + 1]; e++)
+            {
+                if(part[v] != part[g.adjncy[e]])
+                    cut++;
+            }
+        }
+        return cut / 2; // every edge is seen from both ends
+    }
+
+    double imbalance(const graph& g, const std::vector<int>& part, int nparts)
+    {
+        std::vector<double> w(nparts, 0.0);
+        for(size_t v = 0; v < g.size(); v++)
+            w[part[v]] += g.w(v);
+
+        double mean = std::accumulate(w.begin(), w.end(), 0.0) / nparts;
+        return mean > 0 ? *std::max_element(w.begin(), w.end()) / mean : 1.0;
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "exception.hpp"
+
+/**
+ * Partitioning of the face adjacency graph into one part per MPI process.
+ *
+ * The built-in partitioner is a recursive bisection. Each bisection makes an initial split with the given share of the
+ * weight on each side, then moves boundary faces between the sides while that reduces the edge cut and keeps the
+ * balance. If vertex coordinates are available the initial split is a straight cut across the longest extent of the
+ * sub-graph, otherwise one side is grown breadth-first from a pseudo-peripheral vertex. If CHM is built with METIS
+ * (USE_METIS) its k-way partitioner may be used instead.
+ */
+namespace partitioner
+{
+    enum class method
+    {
+        block,     // equal contiguous ranges of face ids, ignores the graph
+        bisection, // built-in recursive graph bisection
+        metis      // METIS k-way, requires USE_METIS
+    };
+
+    /**
+     * Parses a method name (block, bisection, metis). Throws config_error if unknown or not available.
+     */
+    method from_string(const std::string& name);
+
+    /**
+     * Undirected graph in compressed sparse row form. The neighbours of vertex v are adjncy[xadj[v]] ... adjncy[xadj[v+1]-1].
+     * Every edge must be listed in both directions.
+     */
+    struct graph
+    {
+        std::vector<size_t> xadj;
+        std::vector<size_t> adjncy;
+        std::vector<double> weight; // per vertex. If empty, all vertices have weight 1
+        std::vector< std::array<double, 2> > xy; // per vertex position, optional
+
+        size_t size() const { return xadj.empty() ? 0 : xadj.size() - 1; }
+        double w(size_t v) const { return weight.empty() ? 1.0 : weight[v]; }
+    };
+
+    /**
+     * Partitions the graph into nparts parts of approximately equal weight.
+     * @param g
+     * @param nparts
+     * @param m
+     * @return part of each vertex, in [0, nparts)
+     */
+    std::vector<int> partition(const graph& g, int nparts, method m);
+
+    /**
+     * Number of edges that join vertices in different parts
+     */
+    size_t edge_cut(const graph& g, const std::vector<int>& part);
+
+    /**
+     * Heaviest part weight divided by the mean part weight. 1 is perfectly balanced
+     */
+    double imbalance(const graph& g, const std::vector<int>& part, int nparts);
+}
@@ -0,0 +1,155 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exception.hpp"
+
+/**
+ * Space-filling curves used to give the mesh faces an order in which faces that are close in space are also close in
+ * memory. This improves the cache behaviour of neighbour stencils and gives contiguous MPI partitions that are compact.
+ */
+namespace sfc
+{
+    enum class curve
+    {
+        none,
+        hilbert,
+        morton
+    };
+
+    /// Number of bits per axis of the grid the points are quantized onto
+    const unsigned int bits = 16;
+
+    /**
+     * Parses a curve name (none, hilbert, morton). Throws config_error if unknown.
+     */
+    inline curve from_string(const std::string& name)
+    {
+        if(name == "none")
+            return curve::none;
+        if(name == "hilbert")
+            return curve::hilbert;
+        if(name == "morton")
+            return curve::morton;
+
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Unknown space filling curve " + name + ". Options are none, hilbert or morton."));
+    }
+
+    /**
+     * Distance along the Hilbert curve of cell (x,y) on a 2^order x 2^order grid
+     */
+    inline uint64_t hilbert(uint32_t x, uint32_t y, unsigned int order = bits)
+    {
+        uint64_t n = uint64_t(1) << order;
+        uint64_t d = 0;
+        for (uint64_t s = n / 2; s > 0; s /= 2)
+        {
+            uint64_t rx = (x & s) > 0;
+            uint64_t ry = (y & s) > 0;
+            d += s * s * ((3 * rx) ^ ry);
+
+            // rotate the quadrant so the sub-curve has the right orientation
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = static_cast<uint32_t>(n - 1 - x);
+                    y = static_cast<uint32_t>(n - 1 - y);
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    /**
+     * Morton (Z-order) index of cell (x,y): the bits of x and y interleaved
+     */
+    inline uint64_t morton(uint32_t x, uint32_t y)
+    {
+        auto spread = [](uint64_t v)
+        {
+            v &= 0xFFFFFFFF;
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFF;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FF;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0F;
+            v = (v | (v << 2)) & 0x3333333333333333;
+            v = (v | (v << 1)) & 0x5555555555555555;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+
+    /**
+     * Orders points along a space-filling curve. The points are quantized onto a 2^bits grid covering their bounding box.
+     * Points in the same cell keep their input order.
+     * @param pts (x,y) of each point
+     * @param c Curve to use. curve::none returns the identity
+     * @return permutation where permutation[new index] = old index
+     */
+    inline std::vector<size_t> order(const std::vector< std::array<double, 2> >& pts, curve c)
+    {
+        std::vector<size_t> permutation(pts.size());
+        std::iota(permutation.begin(), permutation.end(), 0);
+
+        if(c == curve::none || pts.empty())
+            return permutation;
+
+        double min_x = pts[0][0], max_x = pts[0][0];
+        double min_y = pts[0][1], max_y = pts[0][1];
+        for(auto& p : pts)
+        {
+            min_x = std::min(min_x, p[0]);
+            max_x = std::max(max_x, p[0]);
+            min_y = std::min(min_y, p[1]);
+            max_y = std::max(max_y, p[1]);
+        }
+
+        // same scale on both axes so the curve isn't stretched on elongated domains
+        double extent = std::max(max_x - min_x, max_y - min_y);
+        double cells = double((uint64_t(1) << bits) - 1);
+        double scale = extent > 0 ? cells / extent : 0;
+
+        std::vector<uint64_t> key(pts.size());
+        for(size_t i = 0; i < pts.size(); i++)
+        {
+            auto x = static_cast<uint32_t>((pts[i][0] - min_x) * scale);
+            auto y = static_cast<uint32_t>((pts[i][1] - min_y) * scale);
+            key[i] = c == curve::hilbert ? hilbert(x, y) : morton(x, y);
+        }
+
+        std::stable_sort(permutation.begin(), permutation.end(),
+                         [&key](size_t a, size_t b) { return key[a] < key[b]; });
+
+        return permutation;
+    }
+}
@@ -16,6 +16,43 @@
 
 
 #include "triangulation.hpp"
+#include "mesh_cache.hpp"
+
+// Faces within this distance (m) of a process' boundary are loaded as ghost faces
+static const double ghost_face_distance = 100.0;
+
+// Reads the given rows of a 1D dataset using a point selection. Rows are returned in the order given.
+template<typename T>
+static std::vector<T> read_rows(H5::DataSet& dataset, const H5::DataType& type, const std::vector<hsize_t>& rows)
+{
+    std::vector<T> out(rows.size());
+    if(rows.empty())
+        return out;
+
+    H5::DataSpace dataspace = dataset.getSpace();
+    dataspace.selectElements(H5S_SELECT_SET, rows.size(), rows.data());
+
+    hsize_t n = rows.size();
+    H5::DataSpace memspace(1, &n);
+    dataset.read(out.data(), type, memspace, dataspace);
+    return out;
+}
+
+// Reads rows [start, start + count) of a 1D dataset using a hyperslab
+template<typename T>
+static std::vector<T> read_range(H5::DataSet& dataset, const H5::DataType& type, hsize_t start, hsize_t count)
+{
+    std::vector<T> out(count);
+    if(count == 0)
+        return out;
+
+    H5::DataSpace dataspace = dataset.getSpace();
+    dataspace.selectHyperslab(H5S_SELECT_SET, &count, &start);
+
+    H5::DataSpace memspace(1, &count);
+    dataset.read(out.data(), type, memspace, dataspace);
+    return out;
+}
 
 triangulation::triangulation()
 {
@@ -29,12 +66,17 @@ triangulation::triangulation()
     _is_geographic = false;
     _UTM_zone = 0;
     _terrain_deformed=false;
+    _reorder_curve = sfc::curve::none;
+    _partition_method = partitioner::method::block;
+    _distributed_load = false;
+    _cache_hash = 0;
     _min_z =  999999;
     _max_z = -999999;
 
 #ifdef USE_SPARSEHASH
     data.set_empty_key("");
     vectors.set_empty_key("");
+    static_data.set_empty_key("");
     vertex_data.set_empty_key("");
 
 #endif
@@ -194,6 +236,86 @@ std::vector< mesh_elem > triangulation::find_faces_in_radius(double x, double y,
 
 
 
+std::shared_ptr<const horizon_map> triangulation::horizon(size_t nsectors, double max_distance)
+{
+    auto key = std::make_pair(nsectors, max_distance);
+    auto itr = _horizons.find(key);
+    if (itr != _horizons.end())
+        return itr->second;
+
+    PROFILE_SCOPE("horizon_map");
+
+    size_t nfaces = size_faces();
+    auto map = std::make_shared<horizon_map>(nfaces, nsectors, max_distance);
+
+    std::string cache_path;
+    uint64_t cache_hash = 0;
+    if (!_cache_path.empty())
+    {
+        cache_path = _cache_path + ".horizon." + std::to_string(nsectors) + "." + std::to_string(max_distance);
+        cache_hash = mesh_cache::hash_string(std::to_string(nsectors) + " " + std::to_string(max_distance), _cache_hash);
+
+        mesh_cache::reader cache;
+        if (cache.open(cache_path, cache_hash) && cache.read<uint64_t>() == nfaces)
+        {
+            LOG_DEBUG << "Using the cached horizons " << cache_path;
+            map->data() = cache.read_vector<uint16_t>();
+            _horizons[key] = map;
+            return map;
+        }
+    }
+
+    LOG_DEBUG << "Computing the horizons in " << nsectors << " sectors out to " << max_distance << " m";
+
+    double width = 360. / nsectors;
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < nfaces; i++)
+    {
+        auto f = face(i);
+        Point_3 me = f->center();
+
+        for (size_t k = 0; k < nsectors; k++)
+        {
+            double phi = 0.;
+            walk_ray(f, k * width, max_distance, [&](const ray_hit& hit)
+            {
+                double z_diff = hit.face->center().z() - me.z();
+                if (hit.face != f && z_diff > 0)
+                {
+                    double dist = math::gis::distance(hit.face->center(), me);
+                    phi = std::max(atan(z_diff / dist), phi);
+                }
+                return true;
+            });
+
+            map->set(f->cell_local_id, k, phi);
+        }
+    }
+
+    if (!cache_path.empty())
+    {
+        mesh_cache::writer cache(cache_path, cache_hash);
+        cache.write<uint64_t>(nfaces);
+        cache.write_array(map->data());
+        cache.close();
+    }
+
+    _horizons[key] = map;
+    return map;
+}
+
+std::vector<ray_hit> triangulation::walk_ray(mesh_elem start, double bearing, double max_distance) const
+{
+    std::vector<ray_hit> hits;
+    walk_ray(start, bearing, max_distance, [&](const ray_hit& hit)
+    {
+        hits.push_back(hit);
+        return true;
+    });
+    return hits;
+}
+
 mesh_elem triangulation::find_closest_face(Point_2 query) const
 {
     K_neighbor_search search(*dD_tree, query, 1);
@@ -526,6 +648,8 @@ void triangulation::from_json(pt::ptree &mesh)
         LOG_DEBUG << "No face permutation.";
     }
 
+    reorder_by_curve();
+
     partition_mesh();
 #ifdef USE_MPI
     _num_faces = _local_faces.size();
@@ -533,6 +657,7 @@ void triangulation::from_json(pt::ptree &mesh)
     determine_process_ghost_faces_nearest_neighbors();
 
     setup_nearest_neighbor_communication();
+    report_partition();
 
     // should make this parallel
     for(size_t ii=0; ii < _num_global_faces; ++ii)
@@ -594,6 +719,8 @@ void triangulation::from_json(pt::ptree &mesh)
     f->normal();
   }
 
+  build_geometry();
+
     // TODO need to re-setup dD_tree to only consider the _faces after shrinking
     // -  Note this likely allows us to remove the the ifndef USE_MPI from earlier in this routine,
     //    as we have to do a global pass and a local pass anyway
@@ -717,29 +844,39 @@ void triangulation::to_hdf5(std::string filename_base)
 ////////////////////////////////////////////////////////////////////////////
 
   std::string par_filename = filename_base + "_param.h5";
+  // the mesh above is written in the current face order, so the parameters must be too
+  write_parameters_hdf5(par_filename, std::vector<std::string>(_parameters.begin(), _parameters.end()), false);
+
+  std::cout << "Written file example.h5\n";
+
+}
 
+void triangulation::write_parameters_hdf5(const std::string& filename, const std::vector<std::string>& parameters,
+                                          bool file_order)
+{
   try {
     // Turn off the auto-printing when failure occurs so that we can
     // handle the errors appropriately
     Exception::dontPrint();
 
-    H5::H5File file(par_filename,H5F_ACC_TRUNC);
+    H5::H5File file(filename,H5F_ACC_TRUNC);
     H5::Group group(file.createGroup("/parameters"));
 
     hsize_t ntri= size_global_faces();
 
-    for (auto &par_iter : _parameters) {
+    for (auto &par_iter : parameters) {
 
       H5::DataSpace dataspace(1, &ntri);
-      auto globalIDs = get_global_IDs();
       std::string par_location = "/parameters/" + par_iter;
       H5::DataSet dataset = file.createDataSet(par_location, PredType::NATIVE_DOUBLE, dataspace);
 
+      // scatter back to the rows of the mesh file, as from_hdf5 reads them through _file_face_index
       std::vector<double> values(ntri);
 #pragma omp parallel for
       for(size_t i=0; i<ntri; ++i) {
 	auto face = _faces.at(i);
-	values[i] = face->parameter(par_iter);
+	size_t row = file_order && !_file_face_index.empty() ? _file_face_index[face->cell_global_id] : i;
+	values[row] = face->parameter(par_iter);
       }
       dataset.write(values.data(), PredType::NATIVE_DOUBLE);
     }
@@ -755,9 +892,6 @@ void triangulation::to_hdf5(std::string filename_base)
   catch (DataSetIException error) {
     error.printErrorStack();
   }
-
-  std::cout << "Written file example.h5\n";
-
 }
 
 void attr_op(H5::H5Location &loc, const std::string attr_name,
@@ -794,6 +928,18 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
   std::vector<int> permutation;
   std::vector<Point_2> center_points;
 
+  bool distributed = false;
+#ifdef USE_MPI
+  distributed = _distributed_load && _comm_world.size() > 1;
+#endif
+
+  if(distributed)
+  {
+    // only this process' faces and their halo are read and created
+    read_local_hdf5_mesh(mesh_filename);
+  }
+  else
+  {
     try {
         // Turn off the auto-printing when failure occurs so that we can
         // handle the errors appropriately
@@ -990,7 +1136,42 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
         error.printErrorStack();
     }
 
+    reorder_by_curve();
+
+#ifdef USE_MPI
+    // the parameters are only read after partitioning, so read the partition weight now
+    if(!_partition_weight_parameter.empty() && _partition_method != partitioner::method::block)
+    {
+      for(auto param_filename : param_filenames)
+      {
+        H5File file(param_filename, H5F_ACC_RDONLY);
+        Group group = file.openGroup("parameters");
+        if(H5Lexists(group.getId(), _partition_weight_parameter.c_str(), H5P_DEFAULT) <= 0)
+          continue;
+
+        DataSet dataset = group.openDataSet(_partition_weight_parameter);
+        hsize_t nelem;
+        dataset.getSpace().getSimpleExtentDims(&nelem);
+        std::vector<double> data(nelem);
+        dataset.read(data.data(), PredType::NATIVE_DOUBLE);
+
+        _partition_weights.resize(_faces.size());
+        for (size_t i = 0; i < _faces.size(); ++i)
+        {
+          _partition_weights[i] = data.at(_file_face_index.empty() ? i : _file_face_index[i]);
+        }
+        break;
+      }
+
+      if(_partition_weights.empty())
+      {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Partition weight parameter " + _partition_weight_parameter + " is not in any parameter file."));
+      }
+    }
+#endif
+
     partition_mesh();
+  } // !distributed
 
 #ifdef USE_MPI
     _num_faces = _local_faces.size();
@@ -998,13 +1179,14 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
     determine_process_ghost_faces_nearest_neighbors();
 
     setup_nearest_neighbor_communication();
+    report_partition();
 
     // Region
     // TODO: Need to auto-determine how far to look based on module setups
-    determine_process_ghost_faces_by_distance(100.0);
+    determine_process_ghost_faces_by_distance(ghost_face_distance);
 
-    // should make this parallel
-    for(size_t ii=0; ii < _num_global_faces; ++ii)
+    // _faces holds every face for a full load, or the owned and halo faces for a distributed load
+    for(size_t ii=0; ii < _faces.size(); ++ii)
     {
         auto face = _faces.at(ii);
         Point_2 pt2(face->center().x(),face->center().y());
@@ -1089,6 +1271,27 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
 	  // 				      "Param " + name + " expected: " + std::to_string(_faces.size()) + " values, got: " + std::to_string(nelem)));
 	  // }
 
+	  if(!_file_face_index.empty())
+	  {
+	    // The faces were reordered after they were read so the local faces are no longer a contiguous block of the file.
+	    // Read the whole parameter and pick out the local and ghost faces.
+	    std::vector<double> all(nelem);
+	    dataset.read(all.data(), PredType::NATIVE_DOUBLE);
+
+#pragma omp parallel for
+	    for (size_t i=0;i<_num_faces;i++){
+	      auto f = face(i);
+	      f->parameter(name) = all[_file_face_index[f->cell_global_id]];
+	    }
+
+	    for (size_t i = 0; i < _ghost_faces.size(); i++) {
+	      auto f = _ghost_faces.at(i);
+	      f->parameter(name) = all[_file_face_index[f->cell_global_id]];
+	    }
+
+	    continue;
+	  }
+
 	  dataset.read(data.data(), PredType::NATIVE_DOUBLE, memspace, dataspace);
 
 	  // for(int i=0;i<5;++i){
@@ -1103,22 +1306,14 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
 
 	  LOG_DEBUG << " Applying " << name << " for ghost regions (" << _ghost_faces.size() << " elements): " << name;
 
-	  // Read parameters for each ghost face individually
-	  hsize_t one = 1;
-	  // Do NOT do this loop in parallel (internal state of HDF5)
+	  // Read the parameters for all the ghost faces with a single point selection
+	  std::vector<hsize_t> ghost_rows(_ghost_faces.size());
 	  for (size_t i = 0; i < _ghost_faces.size(); i++) {
-	    auto face = _ghost_faces.at(i);
-	    hsize_t global_id = face->cell_global_id;
-
-	    // Position and size in file
-	    dataspace.selectHyperslab( H5S_SELECT_SET, &one, &global_id);
-	    // Position and size in variable
-	    memspace.selectHyperslab(H5S_SELECT_SET, &one, &zero);
-
-	    double value;
-	    dataset.read(&value, PredType::NATIVE_DOUBLE, memspace, dataspace);
-	    face->parameter(name) = value;
-
+	    ghost_rows[i] = _ghost_faces.at(i)->cell_global_id;
+	  }
+	  auto ghost_values = read_rows<double>(dataset, PredType::NATIVE_DOUBLE, ghost_rows);
+	  for (size_t i = 0; i < _ghost_faces.size(); i++) {
+	    _ghost_faces.at(i)->parameter(name) = ghost_values[i];
 	  }
 
 
@@ -1141,156 +1336,865 @@ void triangulation::from_hdf5(const std::string& mesh_filename,
 
 // TODO: include initial condition files
 
+    // the area of geographic meshes comes from the parameters, so this must be after they are read
+    build_geometry();
+
 }
 
-void triangulation::reorder_faces(std::vector<size_t> permutation)
+void triangulation::read_local_hdf5_mesh(const std::string& mesh_filename)
 {
-  // NOTE: be careful with evaluating this, the 'cell_global_id's and a
-  // cell's position in the '_faces' vec are unrelated. They must both
-  // be modified (ie. renumber the 'cell_global_id's, AND sort the '_faces'
-  // vector) before the new ordering is consistent.
+#ifdef USE_MPI
+  PROFILE_SCOPE("read_local_hdf5_mesh");
 
-  assert( permutation.size() == size_faces() );
-  LOG_DEBUG << "Reordering faces";
+  H5File file(mesh_filename, H5F_ACC_RDONLY);
 
+  {
+    H5::Attribute attribute = file.openAttribute("/mesh/proj4");
+    attribute.read(proj4_t, _srs_wkt);
+  }
+  {
+    H5::Attribute attribute = file.openAttribute("/mesh/is_geographic");
+    attribute.read(PredType::NATIVE_HBOOL, &_is_geographic);
+  }
 
+  DataSet vertex_ds = file.openDataSet("/mesh/vertex");
+  DataSet elem_ds = file.openDataSet("/mesh/elem");
+  DataSet neigh_ds = file.openDataSet("/mesh/neighbor");
 
-  // Update the IDs on all faces
-  #pragma omp parallel for
-  for (size_t ind = 0; ind < permutation.size(); ++ind)
+  hsize_t nelem;
+  elem_ds.getSpace().getSimpleExtentDims(&nelem, NULL);
+  _num_global_faces = nelem;
+
+  // The same contiguous block partition as partition_mesh, which only needs the number of faces
+  int my_rank = _comm_world.rank();
+  _num_faces_in_partition.assign(_comm_world.size(), _num_global_faces / _comm_world.size());
+  for (unsigned int i = 0; i < _num_global_faces % _comm_world.size(); ++i)
+  {
+    _num_faces_in_partition[i]++;
+  }
+  size_t start = 0;
+  for (int i = 0; i < my_rank; ++i)
   {
+    start += _num_faces_in_partition[i];
+  }
+  size_t count = _num_faces_in_partition[my_rank];
+  global_cell_start_idx = start;
+  global_cell_end_idx = start + count - 1;
 
-	     size_t old_ID = permutation.at(ind);
-	     size_t new_ID = ind;
+  auto is_owned = [start, count](size_t id) { return id >= start && id < start + count; };
 
-	     auto face = _faces.at(old_ID);
-	     face->cell_global_id = new_ID;
+  // rows read so far, keyed by face or vertex id
+  std::unordered_map< size_t, std::array<int,3> > elem_rows;
+  std::unordered_map< size_t, std::array<int,3> > neigh_rows;
+  std::unordered_map< size_t, std::array<double,3> > vertex_rows;
 
-  }
+  // reads the vertices of the given faces that haven't been read yet
+  auto read_vertices = [&](const std::vector<hsize_t>& faces)
+  {
+    std::set<hsize_t> missing;
+    for (auto f : faces)
+    {
+      for (auto v : elem_rows[f])
+      {
+        if (vertex_rows.find(v) == vertex_rows.end())
+          missing.insert(v);
+      }
+    }
+    std::vector<hsize_t> ids(missing.begin(), missing.end());
+    auto rows = read_rows< std::array<double,3> >(vertex_ds, vertex_t, ids);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      vertex_rows[ids[i]] = rows[i];
+    }
+  };
 
-  // Sort the faces in the new ordering
-  tbb::parallel_sort(_faces.begin(), _faces.end(),
-  		     [](triangulation::Face_handle fa, triangulation::Face_handle fb)->bool
-  		     {
-  		       return fa->cell_global_id < fb->cell_global_id;
-  		     });
-}
+  // reads the faces (and their vertices) that haven't been read yet
+  auto read_faces = [&](const std::vector<hsize_t>& faces)
+  {
+    std::set<hsize_t> missing;
+    for (auto f : faces)
+    {
+      if (elem_rows.find(f) == elem_rows.end())
+        missing.insert(f);
+    }
+    std::vector<hsize_t> ids(missing.begin(), missing.end());
+    auto e = read_rows< std::array<int,3> >(elem_ds, elem_t, ids);
+    auto n = read_rows< std::array<int,3> >(neigh_ds, neighbor_t, ids);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      elem_rows[ids[i]] = e[i];
+      neigh_rows[ids[i]] = n[i];
+    }
+    read_vertices(ids);
+  };
 
-void triangulation::partition_mesh()
-{
-  /*
-    Basically, this first attempt splits the number of mesh points as equally as possible
-  */
-  // 1. Determine number of (processor) locally owned faces
-  // 2. Determine (processor) locally owned indices of faces
-  // 3. Set locally owned is_ghost=false
+  auto center = [&](size_t f)
+  {
+    double x = 0, y = 0, z = 0;
+    for (auto v : elem_rows.at(f))
+    {
+      auto& p = vertex_rows.at(v);
+      x += p[0];
+      y += p[1];
+      z += p[2];
+    }
+    return Point_3(x / 3., y / 3., z / 3.);
+  };
 
-  _num_global_faces = _faces.size();
+  // owned faces are a contiguous block of the file
+  {
+    auto e = read_range< std::array<int,3> >(elem_ds, elem_t, start, count);
+    auto n = read_range< std::array<int,3> >(neigh_ds, neighbor_t, start, count);
+    std::vector<hsize_t> ids(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      ids[i] = start + i;
+      elem_rows[start + i] = e[i];
+      neigh_rows[start + i] = n[i];
+    }
+    read_vertices(ids);
+  }
 
-#ifdef USE_MPI
+  // Find the halo with the same search determine_process_ghost_faces_by_distance does on the full mesh: walk the
+  // neighbors out from each owned face on the process or domain boundary, staying within ghost_face_distance of it.
+  // This is done a ring at a time so each ring is a single read.
+  std::set<size_t> halo;
+  std::vector< std::pair<size_t,size_t> > frontier; // (face, boundary face it was reached from)
+  for (size_t f = start; f < start + count; ++f)
+  {
+    bool boundary = false;
+    for (auto n : neigh_rows[f])
+    {
+      if (n == -1 || !is_owned(n))
+        boundary = true;
+      // direct neighbors are always needed for the nearest neighbor communication
+      if (n != -1 && !is_owned(n))
+        halo.insert(n);
+    }
+    if (boundary)
+      frontier.push_back(std::make_pair(f, f));
+  }
 
-  LOG_DEBUG << "Partitioning mesh";
+  std::unordered_set<uint64_t> visited; // face * nelem + boundary face
+  while (!frontier.empty())
+  {
+    std::vector<hsize_t> ids;
+    for (auto& itr : frontier)
+      ids.push_back(itr.first);
+    read_faces(ids);
 
-  int my_rank = _comm_world.rank();
+    std::vector< std::pair<size_t,size_t> > next;
+    for (auto& itr : frontier)
+    {
+      size_t f = itr.first;
+      size_t b = itr.second;
+      if (!visited.insert(uint64_t(f) * nelem + b).second)
+        continue;
+      if (math::gis::distance(center(b), center(f)) > ghost_face_distance)
+        continue;
 
-  // Set up so that all processors know how 'big' all other processors are
-  _num_faces_in_partition.resize(_comm_world.size(),
-				 _num_global_faces/_comm_world.size());
-  for (unsigned int i=0;i<_num_global_faces%_comm_world.size();++i) {
-    _num_faces_in_partition[i]++;
+      if (!is_owned(f))
+        halo.insert(f);
+
+      for (auto n : neigh_rows.at(f))
+      {
+        if (n != -1 && visited.find(uint64_t(n) * nelem + b) == visited.end())
+          next.push_back(std::make_pair(size_t(n), b));
+      }
+    }
+    frontier.swap(next);
   }
 
-  // each processor only knows its own start and end indices
-  size_t face_start_idx = 0;
-  size_t face_end_idx = _num_faces_in_partition[0]-1;
-  for (int i=1;i<=_comm_world.rank();++i) {
-    face_start_idx += _num_faces_in_partition[i-1];
-    face_end_idx += _num_faces_in_partition[i];
+  read_faces(std::vector<hsize_t>(halo.begin(), halo.end()));
+
+  // local faces in global id order: the owned block with the halo either side
+  std::vector<size_t> ids;
+  ids.reserve(count + halo.size());
+  for (auto f : halo)
+  {
+    if (f < start)
+      ids.push_back(f);
+  }
+  for (size_t f = start; f < start + count; ++f)
+  {
+    ids.push_back(f);
+  }
+  for (auto f : halo)
+  {
+    if (f >= start + count)
+      ids.push_back(f);
   }
-  // Store in the public members
-  global_cell_start_idx = face_start_idx;
-  global_cell_end_idx = face_end_idx;
 
-  // Set size of vector containing locally owned faces
-  _local_faces.resize(_num_faces_in_partition[_comm_world.rank()]);
+  // vertices, keeping their global id
+  std::set<size_t> vertex_ids;
+  for (auto f : ids)
+  {
+    for (auto v : elem_rows.at(f))
+      vertex_ids.insert(v);
+  }
 
-  _global_IDs.resize(_local_faces.size());
-  // Loop can't be parallel due to modifying map
-  for(size_t local_ind=0;local_ind<_local_faces.size();++local_ind)
+  std::unordered_map<size_t, Vertex_handle> vertices;
+  for (auto v : vertex_ids)
   {
-             _global_IDs[local_ind] = face_start_idx + local_ind;
-	     _global_to_locally_owned_index_map[_global_IDs[local_ind]] = local_ind;
+    auto& p = vertex_rows.at(v);
+    _max_z = std::max(_max_z, p[2]);
+    _min_z = std::min(_min_z, p[2]);
+
+    Vertex_handle Vh = this->create_vertex();
+    Vh->set_point(Point_3(p[0], p[1], p[2]));
+    Vh->set_id(v);
+    _vertexes.push_back(Vh);
+    vertices[v] = Vh;
+  }
+  _num_vertex = _vertexes.size();
 
-	     _faces.at(_global_IDs[local_ind])->is_ghost = false;
-	     _faces.at(_global_IDs[local_ind])->owner = my_rank;
-	     _faces.at(_global_IDs[local_ind])->cell_local_id = local_ind;
-	     _local_faces[local_ind] = _faces.at(_global_IDs[local_ind]);
+  // other processes hold the rest of the mesh
+  _max_z = boost::mpi::all_reduce(_comm_world, _max_z, boost::mpi::maximum<double>());
+  _min_z = boost::mpi::all_reduce(_comm_world, _min_z, boost::mpi::minimum<double>());
 
+  std::unordered_map<size_t, mesh_elem> faces;
+  for (auto f : ids)
+  {
+    auto& e = elem_rows.at(f);
+    auto vert1 = vertices.at(e[0]);
+    auto vert2 = vertices.at(e[1]);
+    auto vert3 = vertices.at(e[2]);
+
+    auto face = this->create_face(vert1, vert2, vert3);
+    face->cell_global_id = f;
+    face->cell_local_id = std::numeric_limits<size_t>::max();
+    face->_is_geographic = _is_geographic;
+    face->_debug_ID = -(f + 1);
+    face->_debug_name = std::to_string(f);
+    face->_domain = this;
+
+    vert1->set_face(face);
+    vert2->set_face(face);
+    vert3->set_face(face);
+
+    _faces.push_back(face);
+    faces[f] = face;
   }
 
+  // neighbors outside of the halo weren't loaded and are left as nullptr. Only ghost faces can have these.
+  for (auto f : ids)
+  {
+    Face_handle neigh[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      int n = neigh_rows.at(f)[j];
+      auto itr = n != -1 ? faces.find(n) : faces.end();
+      neigh[j] = itr != faces.end() ? itr->second : nullptr;
+    }
+    faces.at(f)->set_neighbors(neigh[0], neigh[1], neigh[2]);
+  }
 
-  LOG_DEBUG << "MPI Process " << my_rank << ": start " << face_start_idx << ", end " << face_end_idx << ", number " << _local_faces.size();
+  // ownership, as partition_mesh does
+  _local_faces.resize(count);
+  _global_IDs.resize(count);
+  for (size_t local_ind = 0; local_ind < count; ++local_ind)
+  {
+    auto face = faces.at(start + local_ind);
+    _global_IDs[local_ind] = start + local_ind;
+    _global_to_locally_owned_index_map[_global_IDs[local_ind]] = local_ind;
+
+    face->is_ghost = false;
+    face->owner = my_rank;
+    face->cell_local_id = local_ind;
+    _local_faces[local_ind] = face;
+  }
 
+  _num_faces = _faces.size();
 
-#else // do not USE_MPI
+  LOG_DEBUG << "MPI Process " << my_rank << ": start " << start << ", end " << global_cell_end_idx << ", number "
+            << count << ", read " << halo.size() << " halo faces and " << _num_vertex << " vertices of "
+            << _num_global_faces << " faces";
+#endif // USE_MPI
+}
 
-    // If we are not using MPI, some code paths might still want to make use of these
-   //  initialized to [0, num_faces - 1]
-    global_cell_start_idx = 0;
-    global_cell_end_idx = _num_faces - 1;
+bool triangulation::from_cache(const std::string& path, uint64_t input_hash)
+{
+  PROFILE_SCOPE("mesh_cache_read");
 
-  _global_IDs.resize(_num_global_faces);
-#pragma omp parallel for
-  for(size_t i=0;i<_num_global_faces;++i)
+  mesh_cache::reader cache;
+  if(!cache.open(path, input_hash))
   {
-    _global_IDs[i] = i;
-    _faces.at(i)->is_ghost = false;
-    _faces.at(i)->cell_local_id = i; // Mesh has been (potentially) reordered before this point. Set the local_id correctly
+    LOG_DEBUG << "Mesh cache " << path << " is missing or was built from different inputs";
+    return false;
   }
-  LOG_DEBUG << "Face numbering : start 0, end " << (_num_global_faces-1) << ", number " << _local_faces.size();
 
-#endif // USE_MPI
+  if(!math::gis::distance || !math::gis::point_from_bearing)
+  {
+    BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("The distance functions must be set before loading the mesh cache."));
+  }
 
-}
+  LOG_DEBUG << "Loading mesh from cache " << path;
+  _cache_path = path;
+  _cache_hash = input_hash;
 
-void triangulation::determine_local_boundary_faces()
-{
-  /*
-    - Store handles to boundary faces on the locally owned process
-    - Also store boolean value "is_global_boundary"
-  */
+  _is_geographic = (cache.flags() & mesh_cache::flag_geographic) != 0;
+  _srs_wkt = cache.read_string();
 
-  using th_safe_multicontainer_type = std::vector< std::pair<mesh_elem,bool> >[];
+  size_t nvert, nelem, n;
+  const double* vertices = cache.read_array<double>(nvert);
+  nvert /= 3;
 
-#ifdef USE_MPI
-  // Need to ensure we're starting from nothing?
-  assert( _boundary_faces.size() == 0 );
+  for (size_t i = 0; i < nvert; i++)
+  {
+    Point_3 pt(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+    _max_z = std::max(_max_z, pt.z());
+    _min_z = std::min(_min_z, pt.z());
+
+    Vertex_handle Vh = this->create_vertex();
+    Vh->set_point(pt);
+    Vh->set_id(i);
+    _vertexes.push_back(Vh);
+  }
+  _num_vertex = _vertexes.size();
 
-  LOG_DEBUG << "Determining local boundary faces";
+  const int32_t* elem = cache.read_array<int32_t>(nelem);
+  nelem /= 3;
+  const int32_t* neigh = cache.read_array<int32_t>(n);
+  const int32_t* debug_ID = cache.read_array<int32_t>(n);
+  const double* center = cache.read_array<double>(n);
+  const double* normal = cache.read_array<double>(n);
+  const double* slope = cache.read_array<double>(n);
+  const double* aspect = cache.read_array<double>(n);
+  const double* area = cache.read_array<double>(n);
 
-  std::unique_ptr< th_safe_multicontainer_type > th_local_boundary_faces;
+  // empty unless the faces were reordered, in which case the parameter files are still written in the mesh file's order
+  auto file_face_index = cache.read_vector<uint64_t>();
+  _file_face_index.assign(file_face_index.begin(), file_face_index.end());
 
-#pragma omp parallel
+  this->set_dimension(2);
+
+  for (size_t i = 0; i < nelem; i++)
   {
-    // We want an array of vectors, so that OMP threads can increment them
-    // separately, then join them afterwards
-#pragma omp single
-    {
-      th_local_boundary_faces = std::make_unique< th_safe_multicontainer_type >(omp_get_num_threads());
-    }
-#pragma omp for
-    for(size_t face_index=0; face_index< _local_faces.size(); ++face_index)
-      {
-		 // face_index is a local index... get the face handle
-		 auto face = _local_faces.at(face_index);
+    auto vert1 = _vertexes.at(elem[3 * i]);
+    auto vert2 = _vertexes.at(elem[3 * i + 1]);
+    auto vert3 = _vertexes.at(elem[3 * i + 2]);
+
+    auto face = this->create_face(vert1, vert2, vert3);
+    face->cell_global_id = i;
+    face->cell_local_id = i;
+    face->_is_geographic = _is_geographic;
+    face->_debug_ID = debug_ID[i];
+    face->_debug_name = std::to_string(i);
+    face->_domain = this;
+
+    vert1->set_face(face);
+    vert2->set_face(face);
+    vert3->set_face(face);
+
+    _faces.push_back(face);
+  }
+  _num_faces = _faces.size();
 
-		 int num_owned_neighbors = 0;
-		 for (int neigh_index = 0; neigh_index < 3; ++neigh_index)
-		   {
+#pragma omp parallel for
+  for (size_t i = 0; i < nelem; i++)
+  {
+    auto face = _faces.at(i);
 
-		     auto neigh = face->neighbor(neigh_index);
+    //-1 is the no neighbor value
+    Face_handle face0 = neigh[3 * i] != -1 ? _faces.at(neigh[3 * i]) : nullptr;
+    Face_handle face1 = neigh[3 * i + 1] != -1 ? _faces.at(neigh[3 * i + 1]) : nullptr;
+    Face_handle face2 = neigh[3 * i + 2] != -1 ? _faces.at(neigh[3 * i + 2]) : nullptr;
+    face->set_neighbors(face0, face1, face2);
 
-		     // Test status of neighbor
+    face->set_geometry(Point_3(center[3 * i], center[3 * i + 1], center[3 * i + 2]),
+                       Vector_3(normal[3 * i], normal[3 * i + 1], normal[3 * i + 2]),
+                       slope[i], aspect[i], area[i]);
+  }
+
+  // Parameters, in addition to any provided by the modules that were already added to _parameters
+  size_t nparam = cache.read<uint64_t>();
+  std::vector<std::string> param_names(nparam);
+  std::vector<const double*> param_values(nparam);
+  for (size_t p = 0; p < nparam; p++)
+  {
+    param_names[p] = cache.read_string();
+    param_values[p] = cache.read_array<double>(n);
+    _parameters.insert(param_names[p]);
+  }
+
+  size_t nic = cache.read<uint64_t>();
+  std::vector<std::string> ic_names(nic);
+  std::vector<const double*> ic_values(nic);
+  for (size_t p = 0; p < nic; p++)
+  {
+    ic_names[p] = cache.read_string();
+    ic_values[p] = cache.read_array<double>(n);
+  }
+
+#pragma omp parallel for
+  for (size_t i = 0; i < nelem; i++)
+  {
+    auto face = _faces.at(i);
+    face->init_parameters(_parameters);
+
+    for (size_t p = 0; p < nparam; p++)
+      face->parameter(param_names[p]) = param_values[p][i];
+
+    for (size_t p = 0; p < nic; p++)
+      face->set_initial_condition(ic_names[p], ic_values[p][i]);
+  }
+
+  partition_mesh();
+
+#ifdef USE_MPI
+  _num_faces = _local_faces.size();
+  determine_local_boundary_faces();
+  determine_process_ghost_faces_nearest_neighbors();
+
+  setup_nearest_neighbor_communication();
+  report_partition();
+
+  determine_process_ghost_faces_by_distance(ghost_face_distance);
+#endif
+
+  // The kd-tree holds pointers to the faces so it can't be stored, but building it from the cached centres is cheap
+  std::vector<Point_2> center_points(nelem);
+  for (size_t i = 0; i < nelem; i++)
+  {
+    center_points[i] = Point_2(center[3 * i], center[3 * i + 1]);
+  }
+  dD_tree = boost::make_shared<Tree>(boost::make_zip_iterator(boost::make_tuple( center_points.begin(),_faces.begin() )),
+                                     boost::make_zip_iterator(boost::make_tuple( center_points.end(), _faces.end() ) )
+  );
+
+  build_geometry();
+
+  LOG_DEBUG << "Loaded a mesh with " << _faces.size() << " triangles from the cache";
+
+  return true;
+}
+
+void triangulation::write_cache(const std::string& path, uint64_t input_hash)
+{
+  PROFILE_SCOPE("mesh_cache_write");
+
+  if(_distributed_load)
+  {
+    BOOST_THROW_EXCEPTION(config_error() << errstr_info("The mesh cache can't be written from a distributed load."));
+  }
+
+  LOG_DEBUG << "Writing mesh cache " << path;
+
+  size_t nvert = _vertexes.size();
+  size_t nelem = _faces.size();
+
+  std::vector<double> vertices(3 * nvert);
+#pragma omp parallel for
+  for (size_t i = 0; i < nvert; i++)
+  {
+    auto v = vertex(i);
+    vertices[3 * i] = v->point().x();
+    vertices[3 * i + 1] = v->point().y();
+    vertices[3 * i + 2] = v->point().z();
+  }
+
+  std::vector<int32_t> elem(3 * nelem), neigh(3 * nelem), debug_ID(nelem);
+  std::vector<double> center(3 * nelem), normal(3 * nelem), slope(nelem), aspect(nelem), area(nelem);
+
+  std::vector<std::string> ic_names = _faces.at(0)->initial_conditions();
+  std::vector<std::string> param_names(_parameters.begin(), _parameters.end());
+  std::vector<std::vector<double>> param_values(param_names.size(), std::vector<double>(nelem));
+  std::vector<std::vector<double>> ic_values(ic_names.size(), std::vector<double>(nelem, -9999.));
+
+#pragma omp parallel for
+  for (size_t i = 0; i < nelem; i++)
+  {
+    auto f = _faces.at(i);
+    for (int j = 0; j < 3; ++j)
+    {
+      elem[3 * i + j] = f->vertex(j)->get_id();
+      auto n = f->neighbor(j);
+      neigh[3 * i + j] = n != nullptr ? static_cast<int32_t>(n->cell_global_id) : -1;
+    }
+    debug_ID[i] = f->_debug_ID;
+
+    auto c = f->center();
+    auto nv = f->normal();
+    for (int j = 0; j < 3; ++j)
+    {
+      center[3 * i + j] = c[j];
+      normal[3 * i + j] = nv[j];
+    }
+    slope[i] = f->slope();
+    aspect[i] = f->aspect();
+    area[i] = f->get_area();
+
+    for (size_t p = 0; p < param_names.size(); p++)
+      param_values[p][i] = f->parameter(param_names[p]);
+
+    for (size_t p = 0; p < ic_names.size(); p++)
+      if(f->has_initial_condition(ic_names[p]))
+        ic_values[p][i] = f->get_initial_condition(ic_names[p]);
+  }
+
+  mesh_cache::writer cache(path, input_hash, _is_geographic ? mesh_cache::flag_geographic : 0);
+  cache.write_string(_srs_wkt);
+  cache.write_array(vertices);
+  cache.write_array(elem);
+  cache.write_array(neigh);
+  cache.write_array(debug_ID);
+  cache.write_array(center);
+  cache.write_array(normal);
+  cache.write_array(slope);
+  cache.write_array(aspect);
+  cache.write_array(area);
+  cache.write_array(std::vector<uint64_t>(_file_face_index.begin(), _file_face_index.end()));
+
+  cache.write<uint64_t>(param_names.size());
+  for (size_t p = 0; p < param_names.size(); p++)
+  {
+    cache.write_string(param_names[p]);
+    cache.write_array(param_values[p]);
+  }
+
+  cache.write<uint64_t>(ic_names.size());
+  for (size_t p = 0; p < ic_names.size(); p++)
+  {
+    cache.write_string(ic_names[p]);
+    cache.write_array(ic_values[p]);
+  }
+
+  cache.close();
+
+  _cache_path = path;
+  _cache_hash = input_hash;
+}
+
+void triangulation::reorder_faces(std::vector<size_t> permutation)
+{
+  // NOTE: be careful with evaluating this, the 'cell_global_id's and a
+  // cell's position in the '_faces' vec are unrelated. They must both
+  // be modified (ie. renumber the 'cell_global_id's, AND sort the '_faces'
+  // vector) before the new ordering is consistent.
+
+  assert( permutation.size() == size_faces() );
+  LOG_DEBUG << "Reordering faces";
+
+
+
+  // Update the IDs on all faces
+  #pragma omp parallel for
+  for (size_t ind = 0; ind < permutation.size(); ++ind)
+  {
+
+	     size_t old_ID = permutation.at(ind);
+	     size_t new_ID = ind;
+
+	     auto face = _faces.at(old_ID);
+	     face->cell_global_id = new_ID;
+
+  }
+
+  // Sort the faces in the new ordering
+  tbb::parallel_sort(_faces.begin(), _faces.end(),
+  		     [](triangulation::Face_handle fa, triangulation::Face_handle fb)->bool
+  		     {
+  		       return fa->cell_global_id < fb->cell_global_id;
+  		     });
+}
+
+void triangulation::set_reorder_curve(sfc::curve curve)
+{
+  _reorder_curve = curve;
+}
+
+void triangulation::reorder_by_curve()
+{
+  if(_reorder_curve == sfc::curve::none)
+    return;
+
+  LOG_DEBUG << "Reordering faces and vertices along a " << (_reorder_curve == sfc::curve::hilbert ? "Hilbert" : "Morton") << " curve";
+
+  // Faces are ordered by their centre. Parameters, initial conditions and neighbours are held by the face (the latter as
+  // handles) and so move with it; only the cell_global_id needs to be renumbered, which reorder_faces does.
+  std::vector< std::array<double,2> > centers(_faces.size());
+#pragma omp parallel for
+  for (size_t i = 0; i < _faces.size(); ++i)
+  {
+    auto c = _faces.at(i)->center();
+    centers[i] = {{ c.x(), c.y() }};
+  }
+
+  auto permutation = sfc::order(centers, _reorder_curve);
+
+  // from_hdf5 creates the faces in file order, so the permutation is also each face's row in the parameter files
+  _file_face_index = permutation;
+
+  reorder_faces(permutation);
+
+  std::vector< std::array<double,2> > points(_vertexes.size());
+#pragma omp parallel for
+  for (size_t i = 0; i < _vertexes.size(); ++i)
+  {
+    points[i] = {{ _vertexes[i]->point().x(), _vertexes[i]->point().y() }};
+  }
+
+  auto vertex_permutation = sfc::order(points, _reorder_curve);
+
+  std::vector< Delaunay::Vertex_handle > vertexes(_vertexes.size());
+  for (size_t i = 0; i < vertex_permutation.size(); ++i)
+  {
+    vertexes[i] = _vertexes[vertex_permutation[i]];
+    vertexes[i]->set_id(i);
+  }
+  _vertexes.swap(vertexes);
+}
+
+void triangulation::set_distributed_load(bool distributed)
+{
+  _distributed_load = distributed;
+}
+
+void triangulation::set_partition_method(partitioner::method method)
+{
+  _partition_method = method;
+}
+
+void triangulation::set_partition_weight(const std::string& parameter)
+{
+  _partition_weight_parameter = parameter;
+}
+
+void triangulation::report_partition()
+{
+#ifdef USE_MPI
+  // faces sent to other processes per exchange of one variable
+  size_t send_volume = 0;
+  for (auto& itr : local_indices_to_send)
+  {
+    send_volume += itr.second.size();
+  }
+
+  std::vector<size_t> local = { _local_faces.size(), _ghost_neighbors.size(), send_volume, _comm_partner_ownership.size() };
+  std::vector< std::vector<size_t> > all;
+  boost::mpi::gather(_comm_world, local, all, 0);
+
+  if(_comm_world.rank() == 0)
+  {
+    size_t total_ghosts = 0, total_volume = 0;
+    LOG_DEBUG << "Partition summary (rank: owned faces, ghost neighbors, faces sent per exchange, neighbor processes)";
+    for (size_t r = 0; r < all.size(); ++r)
+    {
+      LOG_DEBUG << "  " << r << ": " << all[r][0] << ", " << all[r][1] << ", " << all[r][2] << ", " << all[r][3];
+      total_ghosts += all[r][1];
+      total_volume += all[r][2];
+    }
+    LOG_DEBUG << "  total ghost neighbors " << total_ghosts << ", total faces sent per exchange " << total_volume;
+  }
+#endif
+}
+
+void triangulation::partition_mesh()
+{
+  /*
+    Basically, this first attempt splits the number of mesh points as equally as possible
+  */
+  // 1. Determine number of (processor) locally owned faces
+  // 2. Determine (processor) locally owned indices of faces
+  // 3. Set locally owned is_ghost=false
+
+  _num_global_faces = _faces.size();
+
+#ifdef USE_MPI
+
+  LOG_DEBUG << "Partitioning mesh";
+
+  int my_rank = _comm_world.rank();
+
+  if(_partition_method != partitioner::method::block && _comm_world.size() > 1)
+  {
+    // Every process partitions the full graph; the partitioners are deterministic so they all agree
+    partitioner::graph g;
+    g.xadj.reserve(_num_global_faces + 1);
+    g.xadj.push_back(0);
+    g.xy.resize(_num_global_faces);
+    for (size_t i = 0; i < _num_global_faces; ++i)
+    {
+      auto f = _faces.at(i);
+      for (int j = 0; j < 3; ++j)
+      {
+        auto neigh = f->neighbor(j);
+        if (neigh != nullptr)
+          g.adjncy.push_back(neigh->cell_global_id);
+      }
+      g.xadj.push_back(g.adjncy.size());
+      g.xy[i] = {{ f->center().x(), f->center().y() }};
+    }
+
+    if(!_partition_weight_parameter.empty())
+    {
+      if(_partition_weights.empty() && !_faces.at(0)->has_parameter(_partition_weight_parameter))
+      {
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Partition weight parameter " + _partition_weight_parameter + " does not exist."));
+      }
+
+      g.weight.resize(_num_global_faces);
+      for (size_t i = 0; i < _num_global_faces; ++i)
+      {
+        double w = _partition_weights.empty() ? _faces.at(i)->parameter(_partition_weight_parameter) : _partition_weights.at(i);
+        // nodata or 0 would let a partition take an unbounded number of faces
+        g.weight[i] = (std::isnan(w) || w <= 0 || w == -9999.) ? 1.0 : w;
+      }
+    }
+
+    auto part = partitioner::partition(g, _comm_world.size(), _partition_method);
+
+    LOG_DEBUG << "Mesh partition edge cut: " << partitioner::edge_cut(g, part) << " (block partition: "
+              << partitioner::edge_cut(g, partitioner::partition(g, _comm_world.size(), partitioner::method::block))
+              << "), weight imbalance: " << partitioner::imbalance(g, part, _comm_world.size());
+
+    // Renumber the faces so each part is a contiguous range of cell_global_id. The rest of the MPI setup, and the hdf5
+    // parameter reads, rely on a process owning a contiguous range.
+    std::vector<size_t> permutation(_num_global_faces);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::stable_sort(permutation.begin(), permutation.end(),
+                     [&part](size_t a, size_t b) { return part[a] < part[b]; });
+
+    if(_file_face_index.empty())
+    {
+      _file_face_index = permutation;
+    }
+    else
+    {
+      std::vector<size_t> file_index(_num_global_faces);
+      for (size_t i = 0; i < _num_global_faces; ++i)
+      {
+        file_index[i] = _file_face_index[permutation[i]];
+      }
+      _file_face_index.swap(file_index);
+    }
+
+    if(!_partition_weights.empty())
+    {
+      std::vector<double> weights(_num_global_faces);
+      for (size_t i = 0; i < _num_global_faces; ++i)
+      {
+        weights[i] = _partition_weights[permutation[i]];
+      }
+      _partition_weights.swap(weights);
+    }
+
+    reorder_faces(permutation);
+
+    _num_faces_in_partition.assign(_comm_world.size(), 0);
+    for (auto p : part)
+    {
+      _num_faces_in_partition[p]++;
+    }
+  }
+  else
+  {
+    // Set up so that all processors know how 'big' all other processors are
+    _num_faces_in_partition.resize(_comm_world.size(),
+				   _num_global_faces/_comm_world.size());
+    for (unsigned int i=0;i<_num_global_faces%_comm_world.size();++i) {
+      _num_faces_in_partition[i]++;
+    }
+  }
+
+  // each processor only knows its own start and end indices
+  size_t face_start_idx = 0;
+  size_t face_end_idx = _num_faces_in_partition[0]-1;
+  for (int i=1;i<=_comm_world.rank();++i) {
+    face_start_idx += _num_faces_in_partition[i-1];
+    face_end_idx += _num_faces_in_partition[i];
+  }
+  // Store in the public members
+  global_cell_start_idx = face_start_idx;
+  global_cell_end_idx = face_end_idx;
+
+  // Set size of vector containing locally owned faces
+  _local_faces.resize(_num_faces_in_partition[_comm_world.rank()]);
+
+  // Faces we don't own have no row in the variable store. Ghost neighbors get theirs later.
+#pragma omp parallel for
+  for(size_t i=0;i<_num_global_faces;++i)
+  {
+    _faces.at(i)->cell_local_id = std::numeric_limits<size_t>::max();
+  }
+
+  _global_IDs.resize(_local_faces.size());
+  // Loop can't be parallel due to modifying map
+  for(size_t local_ind=0;local_ind<_local_faces.size();++local_ind)
+  {
+             _global_IDs[local_ind] = face_start_idx + local_ind;
+	     _global_to_locally_owned_index_map[_global_IDs[local_ind]] = local_ind;
+
+	     _faces.at(_global_IDs[local_ind])->is_ghost = false;
+	     _faces.at(_global_IDs[local_ind])->owner = my_rank;
+	     _faces.at(_global_IDs[local_ind])->cell_local_id = local_ind;
+	     _local_faces[local_ind] = _faces.at(_global_IDs[local_ind]);
+
+  }
+
+
+  LOG_DEBUG << "MPI Process " << my_rank << ": start " << face_start_idx << ", end " << face_end_idx << ", number " << _local_faces.size();
+
+
+#else // do not USE_MPI
+
+    // If we are not using MPI, some code paths might still want to make use of these
+   //  initialized to [0, num_faces - 1]
+    global_cell_start_idx = 0;
+    global_cell_end_idx = _num_faces - 1;
+
+  _global_IDs.resize(_num_global_faces);
+#pragma omp parallel for
+  for(size_t i=0;i<_num_global_faces;++i)
+  {
+    _global_IDs[i] = i;
+    _faces.at(i)->is_ghost = false;
+    _faces.at(i)->cell_local_id = i; // Mesh has been (potentially) reordered before this point. Set the local_id correctly
+  }
+  LOG_DEBUG << "Face numbering : start 0, end " << (_num_global_faces-1) << ", number " << _local_faces.size();
+
+#endif // USE_MPI
+
+}
+
+void triangulation::determine_local_boundary_faces()
+{
+  /*
+    - Store handles to boundary faces on the locally owned process
+    - Also store boolean value "is_global_boundary"
+  */
+
+  using th_safe_multicontainer_type = std::vector< std::pair<mesh_elem,bool> >[];
+
+#ifdef USE_MPI
+  // Need to ensure we're starting from nothing?
+  assert( _boundary_faces.size() == 0 );
+
+  LOG_DEBUG << "Determining local boundary faces";
+
+  std::unique_ptr< th_safe_multicontainer_type > th_local_boundary_faces;
+
+#pragma omp parallel
+  {
+    // We want an array of vectors, so that OMP threads can increment them
+    // separately, then join them afterwards
+#pragma omp single
+    {
+      th_local_boundary_faces = std::make_unique< th_safe_multicontainer_type >(omp_get_num_threads());
+    }
+#pragma omp for
+    for(size_t face_index=0; face_index< _local_faces.size(); ++face_index)
+      {
+		 // face_index is a local index... get the face handle
+		 auto face = _local_faces.at(face_index);
+
+		 int num_owned_neighbors = 0;
+		 for (int neigh_index = 0; neigh_index < 3; ++neigh_index)
+		   {
+
+		     auto neigh = face->neighbor(neigh_index);
+
+		     // Test status of neighbor
 		     if (neigh == nullptr)
 		       {
 			 th_local_boundary_faces[omp_get_thread_num()].push_back(std::make_pair(face,true));
@@ -1415,6 +2319,9 @@ void triangulation::determine_process_ghost_faces_nearest_neighbors()
   for(size_t i=0; i<_ghost_neighbors.size(); ++i)
   {
     _global_index_to_local_ghost_map[_ghost_neighbors[i]->cell_global_id] = static_cast<int>(i);
+
+    // ghost neighbors are stored after the locally owned faces in the variable store
+    _ghost_neighbors[i]->cell_local_id = _local_faces.size() + i;
   }
 
 #ifdef USE_MPI
@@ -1549,6 +2456,7 @@ void triangulation::ghost_neighbors_communicate_variable(const std::string& var)
 
 void triangulation::ghost_neighbors_communicate_variable(const uint64_t& var)
 {
+  PROFILE_SCOPE("ghost_neighbors_communicate_variable");
 
 // Function is meaningful only when using MPI
 #ifdef USE_MPI
@@ -1560,14 +2468,17 @@ void triangulation::ghost_neighbors_communicate_variable(const uint64_t& var)
 
   std::vector<boost::mpi::request> reqs;
 
+  // resolve once, not per face
+  auto h = resolve_variable(var);
+
   for(auto it : local_faces_to_send) {
     auto partner_id = it.first;
     auto faces = it.second;
     std::vector<double> send_buffer(faces.size());
     std::transform(faces.begin(), faces.end(),
 		   send_buffer.begin(),
-		   [var](mesh_elem e){
-		     return (*e)[var]; });
+		   [h](mesh_elem e){
+		     return (*e)[h]; });
 
     // Send variables
     int send_tag = generate_unique_send_tag(_comm_world.rank(), partner_id);
@@ -1596,7 +2507,7 @@ void triangulation::ghost_neighbors_communicate_variable(const uint64_t& var)
 
     auto recv_it = recv_buffer[partner_id].begin();
     for (auto f : faces ) {
-      (*f)[var] = *recv_it;
+      (*f)[h] = *recv_it;
       ++recv_it;
     }
 
@@ -1904,62 +2815,97 @@ void triangulation::init_vtkUnstructured_Grid(std::vector<std::string> output_va
     //assume that all the faces have the same number of variables and the same types of variables
     //by this point this should be a fair assumption
 
+    size_t nfaces = this->size_faces();
+    size_t nrows = _write_ghost_neighbors_to_vtu ? nfaces + _ghost_neighbors.size() : nfaces;
+
+    data.clear();
+    static_data.clear();
+    vectors.clear();
+    vertex_data.clear();
+
+    // arrays are sized once here so that update_vtk_data can fill them in parallel through the raw pointers
+    auto make_array = [nrows](const std::string& name, int ncomponents)
+    {
+        auto a = vtkSmartPointer<vtkFloatArray>::New();
+        a->SetName(name.c_str());
+        a->SetNumberOfComponents(ncomponents);
+        a->SetNumberOfTuples(nrows);
+        return a;
+    };
+
     auto variables = output_variables.size() == 0 ? this->face(0)->variables() : output_variables;
     for(auto& v: variables)
     {
-        data[v] = vtkSmartPointer<vtkFloatArray>::New();
-        data[v]->SetName(v.c_str());
+        data[v] = make_array(v, 1);
     }
 
+    auto vec = this->face(0)->vectors();
+    for(auto& v: vec)
+    {
+        vectors[v] = make_array(v, 3);
+    }
+
+    // Parameters, initial conditions and the geometry don't change between outputs so they are only written here.
+    // If the terrain deforms, the grid is rebuilt and these are rewritten.
     if(_write_parameters_to_vtu)
     {
         auto params = this->face(0)->parameters();
+        auto ics = this->face(0)->initial_conditions();
+
+        std::vector<float*> param_out, ic_out;
         for (auto &v: params)
         {
-            data["[param] " + v] = vtkSmartPointer<vtkFloatArray>::New();
-            data["[param] " + v]->SetName(("[param] " + v).c_str());
+            static_data["[param] " + v] = make_array("[param] " + v, 1);
+            param_out.push_back(static_data["[param] " + v]->GetPointer(0));
         }
-
-        auto ics = this->face(0)->initial_conditions();
         for(auto& v: ics)
         {
-            data["[ic] " + v] = vtkSmartPointer<vtkFloatArray>::New();
-            data["[ic] " + v]->SetName(("[ic] " + v).c_str());
+            static_data["[ic] " + v] = make_array("[ic] " + v, 1);
+            ic_out.push_back(static_data["[ic] " + v]->GetPointer(0));
         }
 
-        //handle elevation/aspect/slope
-        data["Elevation"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["Elevation"]->SetName("Elevation");
-
-        data["Slope"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["Slope"]->SetName("Slope");
-
-        data["Aspect"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["Aspect"]->SetName("Aspect");
-
-        data["Area"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["Area"]->SetName("Area");
-
-        data["is_ghost"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["is_ghost"]->SetName("is_ghost");
+        std::vector<std::string> param_names(params.begin(), params.end());
+        std::vector<std::string> ic_names(ics.begin(), ics.end());
 
+        //handle elevation/aspect/slope
+        float* elevation = (static_data["Elevation"] = make_array("Elevation", 1))->GetPointer(0);
+        float* slope = (static_data["Slope"] = make_array("Slope", 1))->GetPointer(0);
+        float* aspect = (static_data["Aspect"] = make_array("Aspect", 1))->GetPointer(0);
+        float* area = (static_data["Area"] = make_array("Area", 1))->GetPointer(0);
+        float* is_ghost = (static_data["is_ghost"] = make_array("is_ghost", 1))->GetPointer(0);
+        float* global_id = (static_data["global_id"] = make_array("global_id", 1))->GetPointer(0);
 #ifdef USE_MPI
-        data["owner"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["owner"]->SetName("owner");
+        float* owner = (static_data["owner"] = make_array("owner", 1))->GetPointer(0);
 #endif
 
+        #pragma omp parallel for
+        for (size_t i = 0; i < nrows; i++)
+        {
+            // rows past the local faces are the ghost neighbors
+            mesh_elem fit = i < nfaces ? this->face(i) : _ghost_neighbors[i - nfaces];
 
+            for (size_t k = 0; k < param_names.size(); k++)
+            {
+                double d = fit->parameter(param_names[k]);
+                param_out[k][i] = d == -9999. ? nan("") : d;
+            }
 
-        data["global_id"] = vtkSmartPointer<vtkFloatArray>::New();
-        data["global_id"]->SetName("global_id");
+            for (size_t k = 0; k < ic_names.size(); k++)
+            {
+                double d = fit->get_initial_condition(ic_names[k]);
+                ic_out[k][i] = d == -9999. ? nan("") : d;
+            }
 
-    }
-    auto vec = this->face(0)->vectors();
-    for(auto& v: vec)
-    {
-        vectors[v] = vtkSmartPointer<vtkFloatArray>::New();
-        vectors[v]->SetName(v.c_str());
-        vectors[v]->SetNumberOfComponents(3);
+            elevation[i] = fit->get_z();
+            slope[i] = fit->slope();
+            aspect[i] = fit->aspect();
+            area[i] = fit->get_area();
+            is_ghost[i] = fit->is_ghost;
+            global_id[i] = fit->cell_global_id;
+#ifdef USE_MPI
+            owner[i] = i < nfaces ? _comm_world.rank() : nan("");
+#endif
+        }
     }
 
     // Global vertex ids -> only need to be set here, get written in the writer
@@ -1968,17 +2914,175 @@ void triangulation::init_vtkUnstructured_Grid(std::vector<std::string> output_va
     for(int i=0;i<npoints;++i){
       vertex_data["global_id"]->InsertTuple1(i,global_vertex_id[i]);
     }
+
+    for(auto& m : vectors)
+    {
+        _vtk_unstructuredGrid->GetCellData()->AddArray(m.second);
+    }
+
+    for(auto& m : data)
+    {
+        _vtk_unstructuredGrid->GetCellData()->AddArray(m.second);
+    }
+
+    for(auto& m : static_data)
+    {
+        _vtk_unstructuredGrid->GetCellData()->AddArray(m.second);
+    }
+
+    for(auto& m : vertex_data)
+    {
+        _vtk_unstructuredGrid->GetPointData()->AddArray(m.second);
+    }
 }
 
 void triangulation::init_timeseries(std::set< std::string > variables)
 {
+    _variable_store.init(variables, size_faces() + _ghost_neighbors.size());
+}
+
+columnstorage<double>& triangulation::variable_store()
+{
+    return _variable_store;
+}
+
+const std::vector< std::shared_ptr<station> >& triangulation::stations() const
+{
+    return _stations;
+}
+
+const idw_weights& triangulation::station_weights() const
+{
+    return _station_weights;
+}
+
+void triangulation::build_station_weights(const std::vector< std::shared_ptr<station> >& stations, interp_alg ia)
+{
+    _stations = stations;
+
+    std::unordered_map<const station*, uint32_t> index;
+    std::vector<double> sx(stations.size()), sy(stations.size());
+    for (size_t i = 0; i < stations.size(); i++)
+    {
+        index[stations[i].get()] = i;
+        sx[i] = stations[i]->x();
+        sy[i] = stations[i]->y();
+    }
+
+    size_t nfaces = size_faces();
+    std::vector<size_t> offsets{0};
+    std::vector<uint32_t> indices;
+    std::vector<double> qx(nfaces), qy(nfaces);
+
+    for (size_t i = 0; i < nfaces; i++)
+    {
+        auto f = face(i);
+        for (auto& s : f->stations())
+            indices.push_back(index.at(s.get()));
+        offsets.push_back(indices.size());
+
+        qx[i] = f->get_x();
+        qy[i] = f->get_y();
+    }
+
+    if (ia == interp_alg::bilinear_grid)
+    {
+        std::vector<double> weights(indices.size());
+        for (size_t i = 0; i < nfaces; i++)
+        {
+            if (offsets[i + 1] - offsets[i] != 4)
+            {
+                BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("Bilinear interpolation requires each face to have the 4 corners of a grid cell."));
+            }
+
+            double cx[4], cy[4];
+            for (size_t k = 0; k < 4; k++)
+            {
+                cx[k] = sx[indices[offsets[i] + k]];
+                cy[k] = sy[indices[offsets[i] + k]];
+            }
+            bilinear::weights(cx, cy, qx[i], qy[i], &weights[offsets[i]]);
+        }
+
+        _station_weights.init(offsets, indices, weights);
+        return;
+    }
+
+    _station_weights.init(offsets, indices, sx, sy, qx, qy);
+}
+
+const face_geometry& triangulation::geometry() const
+{
+    return _geometry;
+}
+
+void triangulation::build_geometry()
+{
+    PROFILE_SCOPE("build_geometry");
+
+    size_t nfaces = size_faces();
+    size_t nrows = nfaces + _ghost_neighbors.size();
+    _geometry.resize(nrows);
+
+    // the face held in a row, local faces first then the ghost neighbors
+    auto row_face = [&](size_t row) -> mesh_elem
+    {
+        return row < nfaces ? this->face(row) : _ghost_neighbors[row - nfaces];
+    };
+
     #pragma omp parallel for
-    for (size_t it = 0; it < size_faces(); it++)
+    for (size_t i = 0; i < nrows; i++)
     {
-        auto face = this->face(it);
-        face->init_time_series(variables);
+        mesh_elem f = row_face(i);
+        size_t row = f->cell_local_id;
+
+        auto c = f->center();
+        _geometry.x[row] = c.x();
+        _geometry.y[row] = c.y();
+        _geometry.z[row] = c.z();
+
+        auto n = f->normal();
+        _geometry.nx[row] = n.x();
+        _geometry.ny[row] = n.y();
+        _geometry.nz[row] = n.z();
+
+        _geometry.slope[row] = f->slope();
+        _geometry.aspect[row] = f->aspect();
+        _geometry.area[row] = f->get_area();
+
+        for (int j = 0; j < 3; j++)
+        {
+            _geometry.edge_length[row][j] = f->edge_length(j);
+
+            auto en = f->edge_unit_normal(j);
+            _geometry.edge_nx[row][j] = en.x();
+            _geometry.edge_ny[row][j] = en.y();
+
+            // only local faces and ghost neighbors have a row. Any other face, e.g., beyond a ghost neighbor, may
+            // still hold a cell_local_id from before the partition, so check it really is that row's face
+            auto neigh = f->neighbor(j);
+            if (neigh != nullptr && neigh->cell_local_id < nrows && row_face(neigh->cell_local_id) == neigh)
+            {
+                _geometry.neighbor[row][j] = static_cast<int>(neigh->cell_local_id);
+                _geometry.neighbor_distance[row][j] = math::gis::distance(c, neigh->center());
+            }
+            else
+            {
+                _geometry.neighbor[row][j] = -1;
+                _geometry.neighbor_distance[row][j] = neigh != nullptr ? math::gis::distance(c, neigh->center()) : 0;
+            }
+        }
     }
+}
 
+column_handle triangulation::resolve_variable(const uint64_t& variable)
+{
+    return _variable_store.resolve(variable);
+}
+
+column_handle triangulation::resolve_variable(const std::string& variable)
+{
+    return _variable_store.resolve(variable);
 }
 
 void triangulation::init_vectors(std::set<std::string>& variables)
@@ -2005,11 +3109,13 @@ void triangulation::init_face_data(std::set< std::string >& timeseries,
                     std::set< std::string >& vectors,
                     std::set< std::string >& module_data)
 {
+    // variables for both the local faces and ghost neighbors live in the columnar store
+    init_timeseries(timeseries);
+
     #pragma omp parallel for
         for (size_t it = 0; it < size_faces(); it++)
         {
             auto face = this->face(it);
-            face->init_time_series(timeseries);
             face->init_module_data(module_data);
             face->init_vectors(vectors);
         }
@@ -2022,175 +3128,146 @@ void triangulation::init_face_data(std::set< std::string >& timeseries,
         {
             auto face = _ghost_neighbors.at(it);
             face->init_module_data(module_data);
-            face->init_time_series(timeseries);
             face->init_vectors(vectors);
         }}
 
 void triangulation::update_vtk_data(std::vector<std::string> output_variables)
 {
+    PROFILE_SCOPE("update_vtk_data");
+
     //if we haven't inited yet, do so.
     if(!_vtk_unstructuredGrid || _terrain_deformed)
     {
         this->init_vtkUnstructured_Grid(output_variables);
     }
 
-    auto variables = output_variables.size() == 0 ? this->face(0)->variables() : output_variables;
-    auto params = this->face(0)->parameters();
-    auto ics = this->face(0)->initial_conditions();
-    auto vecs = this->face(0)->vectors();
+    size_t nfaces = this->size_faces();
+    size_t nrows = _write_ghost_neighbors_to_vtu ? nfaces + _ghost_neighbors.size() : nfaces;
 
-    for (size_t i = 0; i < this->size_faces(); i++)
+    // resolve each output variable once instead of a string lookup per face
+    std::vector<column_handle> handles;
+    std::vector<float*> out;
+    for (auto& m : data)
     {
-        mesh_elem fit = this->face(i);
-
-        for (auto &v: variables)
-        {
-            double d = (*fit)[v];
-            if(d == -9999.)
-            {
-                d = nan("");
-            }
-
-            data[v]->InsertTuple1(i,d);
-        }
-        if(_write_parameters_to_vtu)
-        {
-            for (auto &v: params)
-            {
-                double d = fit->parameter(v);
-                if (d == -9999.)
-                {
-                    d = nan("");
-                }
-                data["[param] " + v]->InsertTuple1(i, d);
-            }
-
-            for (auto &v: ics)
-            {
-                double d = fit->get_initial_condition(v);
-                if (d == -9999.)
-                {
-                    d = nan("");
-                }
-                data["[ic] " + v]->InsertTuple1(i, d);
-            }
-
-            data["Elevation"]->InsertTuple1(i,fit->get_z());
-            data["Slope"]->InsertTuple1(i,fit->slope());
-            data["Aspect"]->InsertTuple1(i,fit->aspect());
-            data["Area"]->InsertTuple1(i,fit->get_area());
-	    data["is_ghost"]->InsertTuple1(i,fit->is_ghost);
-	    data["global_id"]->InsertTuple1(i,fit->cell_global_id);
-#ifdef USE_MPI
-	    data["owner"]->InsertTuple1(i,_comm_world.rank());
-#endif
-        }
-        for(auto& v: vecs)
-        {
-            Vector_3 d = fit->face_vector(v);
-
-            vectors[v]->InsertTuple3(i,d.x(),d.y(),d.z());
-        }
-
-
+        handles.push_back(_variable_store.resolve(m.first));
+        out.push_back(m.second->GetPointer(0));
     }
 
-    if(_write_ghost_neighbors_to_vtu)
+    // the faces share the vector storage layout, so the vectors are also resolved once, from the first face
+    std::vector<variablestorage<Vector_3>::handle> vec_handles;
+    std::vector<float*> vec_out;
+    for (auto& m : vectors)
     {
+        if (nrows > 0)
+            vec_handles.push_back(this->face(0)->resolve_face_vector(m.first));
+        vec_out.push_back(m.second->GetPointer(0));
+    }
 
-    /* Ghost neighbors */
-    for (size_t i = 0; i < _ghost_neighbors.size(); i++)
+    #pragma omp parallel for
+    for (size_t i = 0; i < nrows; i++)
     {
-        mesh_elem fit = _ghost_neighbors[i];
-
-	size_t insert_offset = i + this->size_faces();
+        // rows past the local faces are the ghost neighbors
+        mesh_elem fit = i < nfaces ? this->face(i) : _ghost_neighbors[i - nfaces];
+        size_t row = fit->cell_local_id;
 
-        for (auto &v: variables)
+        for (size_t k = 0; k < handles.size(); k++)
         {
-            double d = (*fit)[v];
-            if(d == -9999.)
-            {
-                d = nan("");
-            }
-
-            data[v]->InsertTuple1(insert_offset,d);
+            double d = _variable_store(handles[k], row);
+            out[k][i] = d == -9999. ? nan("") : d;
         }
-        if(_write_parameters_to_vtu)
-        {
-            for (auto &v: params)
-            {
-                double d = fit->parameter(v);
-                if (d == -9999.)
-                {
-                    d = nan("");
-                }
-                data["[param] " + v]->InsertTuple1(insert_offset, d);
-            }
-
-            for (auto &v: ics)
-            {
-                double d = fit->get_initial_condition(v);
-                if (d == -9999.)
-                {
-                    d = nan("");
-                }
-                data["[ic] " + v]->InsertTuple1(insert_offset, d);
-            }
 
-            data["Elevation"]->InsertTuple1(insert_offset,fit->get_z());
-            data["Slope"]->InsertTuple1(insert_offset,fit->slope());
-            data["Aspect"]->InsertTuple1(insert_offset,fit->aspect());
-            data["Area"]->InsertTuple1(insert_offset,fit->get_area());
-	    data["is_ghost"]->InsertTuple1(insert_offset,fit->is_ghost);
-	    data["global_id"]->InsertTuple1(insert_offset,fit->cell_global_id);
-	    data["owner"]->InsertTuple1(insert_offset,nan(""));
-        }
-        for(auto& v: vecs)
+        for (size_t k = 0; k < vec_handles.size(); k++)
         {
-            Vector_3 d = fit->face_vector(v);
-
-            vectors[v]->InsertTuple3(insert_offset,d.x(),d.y(),d.z());
+            Vector_3 d = fit->face_vector(vec_handles[k]);
+            vec_out[k][3 * i] = d.x();
+            vec_out[k][3 * i + 1] = d.y();
+            vec_out[k][3 * i + 2] = d.z();
         }
-
-
     }
 
-    } // if write ghosts
-
-    for(auto& m : vectors)
-    {
-        _vtk_unstructuredGrid->GetCellData()->AddArray(m.second);
-
-    }
-
-
+    // the arrays were written through their raw pointers, so let vtk know they changed
     for(auto& m : data)
     {
-        _vtk_unstructuredGrid->GetCellData()->AddArray(m.second);
+        m.second->Modified();
     }
 
-    for(auto& m : vertex_data)
+    for(auto& m : vectors)
     {
-        _vtk_unstructuredGrid->GetPointData()->AddArray(m.second);
+        m.second->Modified();
     }
-
 }
 void triangulation::write_vtu(std::string file_name)
 {
     //this now needs to be called from outside these functions
 //    update_vtk_data();
 
+    write_vtu(_vtk_unstructuredGrid, file_name);
+
+//    write_vtp(file_name);
+}
+
+void triangulation::write_vtu(vtkSmartPointer<vtkUnstructuredGrid> grid, std::string file_name)
+{
+    PROFILE_SCOPE("write_vtu");
+
     vtkSmartPointer<vtkXMLUnstructuredGridWriter> writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
     writer->SetFileName(file_name.c_str());
 //    writer->SetCompressorType( vtkXMLUnstructuredGridWriter::CompressorType::ZLIB);
 #if VTK_MAJOR_VERSION <= 5
-    writer->SetInput(_vtk_unstructuredGrid);
+    writer->SetInput(grid);
 #else
-    writer->SetInputData(_vtk_unstructuredGrid);
+    writer->SetInputData(grid);
 #endif
     writer->Write();
+}
 
-//    write_vtp(file_name);
+vtkSmartPointer<vtkUnstructuredGrid> triangulation::vtk_snapshot()
+{
+    PROFILE_SCOPE("vtk_snapshot");
+
+    if(!_vtk_unstructuredGrid)
+        BOOST_THROW_EXCEPTION(mesh_error() << errstr_info("update_vtk_data must be called before vtk_snapshot."));
+
+    auto snapshot = vtkSmartPointer<vtkUnstructuredGrid>::New();
+
+    // points and cells are only replaced (never modified) when the terrain deforms, so they can be shared
+    snapshot->CopyStructure(_vtk_unstructuredGrid);
+    snapshot->GetFieldData()->ShallowCopy(_vtk_unstructuredGrid->GetFieldData());
+    snapshot->GetPointData()->ShallowCopy(_vtk_unstructuredGrid->GetPointData());
+
+    // the variables and vectors are overwritten every update_vtk_data, so they have to be copied
+    std::vector< vtkSmartPointer<vtkFloatArray> > src, arrays;
+    for (auto& m : vectors)
+    {
+        src.push_back(m.second);
+    }
+    for (auto& m : data)
+    {
+        src.push_back(m.second);
+    }
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        arrays.push_back(vtkSmartPointer<vtkFloatArray>::New());
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        arrays[i]->DeepCopy(src[i]);
+    }
+
+    for (auto& a : arrays)
+    {
+        snapshot->GetCellData()->AddArray(a);
+    }
+
+    // parameters and geometry are only rewritten when the grid is rebuilt, which replaces the arrays
+    for (auto& m : static_data)
+    {
+        snapshot->GetCellData()->AddArray(m.second);
+    }
+
+    return snapshot;
 }
 
 double triangulation::max_z()
@@ -48,6 +48,7 @@ inline int omp_get_max_threads() { return 1;}
 #include <cmath>
 #include <vector>
 #include <set>
+#include <map>
 #include <unordered_set>
 #include <stack>
 #include <fstream>
@@ -129,6 +130,12 @@ namespace pt = boost::property_tree;
 #include "utility/xxh64.hpp"
 
 #include "timeseries/variablestorage.hpp"
+#include "timeseries/columnstorage.hpp"
+#include "space_filling_curve.hpp"
+#include "partitioner.hpp"
+#include "face_geometry.hpp"
+#include "horizon_map.hpp"
+#include "utility/profiler.hpp"
 
 // #include "hdf5.h"
 #include "H5Cpp.h"
@@ -229,6 +236,11 @@ public:
     */
     Point_3 center();
 
+    /**
+    * Sets the precomputed geometry of the face, e.g., from a mesh cache, so that it is not recalculated on first use
+    */
+    void set_geometry(const Point_3& center, const Vector_3& normal, double slope, double aspect, double area);
+
     /**
      * Exactly the same as find_closest_face in triangulation but uses the current face's center
      * @param azimuth
@@ -237,6 +249,15 @@ public:
      */
     const Face_handle find_closest_face(double azimuth, double distance);
 
+    /**
+     * Walks a ray from the current face's center, see triangulation::walk_ray. Works for ghost faces as well.
+     * @param bearing Degrees, CW from north
+     * @param max_distance [m]
+     * @param visit Callable as bool(const ray_hit&), return false to stop
+     */
+    template<typename Visitor>
+    void walk_ray(double bearing, double max_distance, Visitor visit);
+
     /**
      * Returns the ith edge's length. Refering to the docs here
      * http://doc.cgal.org/latest/Triangulation_2/classCGAL_1_1Triangulation__2.html
@@ -320,8 +341,14 @@ public:
      */
     void set_face_vector(const std::string& variable, Vector_3 v);
 
+    /**
+     * Access to this face's row in the triangulation's variable store.
+     * The hash and string variants do a lookup per call and are kept for compatibility;
+     * hot loops should resolve a column_handle once via triangulation::resolve_variable.
+     */
     double& operator[](const uint64_t& variable);
     double& operator[](const std::string& variable);
+    double& operator[](const column_handle& variable);
     /**
      * Returns the face vector for a specified variable
      * @param variable
@@ -329,11 +356,15 @@ public:
      */
     Vector_3 face_vector(const std::string& variable);
 
+    typedef variablestorage<Vector_3>::handle vector_handle;
+
     /**
-    * Initializes  this faces variable storage
-    * \param variables Names of the variables to add
-    */
-    void init_time_series(std::set<std::string>& variables);
+     * Resolves a face vector once, for repeated access via face_vector(const vector_handle&) on this or other faces
+     * @param variable
+     * @return
+     */
+    vector_handle resolve_face_vector(const std::string& variable);
+    Vector_3 face_vector(const vector_handle& variable);
 
     /**
     * Initializes  this faces vector storage
@@ -501,11 +532,13 @@ private:
     //const so we can't modify the domain via this as thar be dragons
     triangulation* _domain;
 
-    boost::shared_ptr<Point_3> _center;
-    boost::shared_ptr<Vector_3> _normal;
+    // held by value, _has_* flag if they have been computed
+    Point_3 _center;
+    Vector_3 _normal;
+    bool _has_center;
+    bool _has_normal;
 
 
-    variablestorage<double> _variables;
     variablestorage<double> _parameters;
 
     variablestorage<face_info*> _module_face_data;
@@ -527,6 +560,17 @@ typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Delaunay;
 typedef Delaunay::Face_handle mesh_elem;
 typedef boost::shared_ptr<tbb::concurrent_vector<double>  > vector;
 
+/**
+ * A face crossed by a ray walked across the mesh with triangulation::walk_ray. Distances are from the start of the ray
+ * (the centre of the start face) to where the ray enters and leaves the face [m].
+ */
+struct ray_hit
+{
+    mesh_elem face;
+    double entry;
+    double exit;
+};
+
 //search tree typedefs
 //http://doc.cgal.org/latest/Spatial_searching/index.html
 typedef K::Point_2 Point_2;
@@ -586,6 +630,17 @@ public:
     */
 	void to_hdf5(std::string filename_base);
 
+    /**
+    * Writes parameters to an hdf5 parameter file, in the layout read by from_hdf5. Requires all the faces, so only for
+    * a single process.
+    * \param filename File to write
+    * \param parameters Names of the parameters to write
+    * \param file_order If the faces were reordered at load, write the values in the order of the mesh file so the
+    * parameter file can be used with it. Otherwise in the current face order.
+    */
+	void write_parameters_hdf5(const std::string& filename, const std::vector<std::string>& parameters,
+	                           bool file_order = true);
+
     /**
     * Reads a mesh and parameters from an hdf5 file.
     * \param mesh_filename Name of mesh file to read .
@@ -596,17 +651,83 @@ public:
 		       const std::vector<std::string>& param_filename,
 		       const std::vector<std::string>& ic_filename);
 
+    /**
+    * Loads the mesh, parameters, initial conditions and face geometry from a cache written by write_cache. The geometry
+    * (centres, normals, slope, aspect, area) is taken from the cache rather than recomputed and the spatial search tree is
+    * rebuilt from the cached centres. The distance functions (math::gis) must already be set up for the cached mesh,
+    * see mesh_cache::flag_geographic.
+    * \param path Cache file
+    * \param input_hash Hash of the inputs the cache must have been built from
+    * \return false, with the mesh untouched, if the cache doesn't exist or is stale
+    */
+  bool from_cache(const std::string& path, uint64_t input_hash);
+
+    /**
+    * Writes the fully initialized mesh to a cache that from_cache can map on a later run. Only valid for a mesh that
+    * holds all of the faces, i.e., not a distributed load.
+    * \param path Cache file
+    * \param input_hash Hash of the inputs the mesh was built from
+    */
+  void write_cache(const std::string& path, uint64_t input_hash);
+
     /**
     * Sets a new order to the face numbering.
     * \param permutation desired ordering
     */
   void reorder_faces(std::vector<size_t> permutation);
 
+    /**
+    * Reads only this MPI process' faces (a contiguous block partition) and the halo of faces within the ghost distance
+    * of them from an hdf5 mesh, using hyperslab and point selections. Replaces the full read and partition_mesh when
+    * the distributed load is enabled.
+    * \param mesh_filename
+    */
+  void read_local_hdf5_mesh(const std::string& mesh_filename);
+
+    /**
+    * If enabled, from_hdf5 in an MPI run with more than one process only reads and creates the faces this process
+    * needs rather than the full mesh. Requires the block partition and no reordering.
+    * \param distributed
+    */
+  void set_distributed_load(bool distributed);
+
+    /**
+    * Selects the space-filling curve used to reorder the faces and vertices when the mesh is loaded.
+    * Must be set before from_json or from_hdf5. Defaults to sfc::curve::none which keeps the file's order.
+    * \param curve
+    */
+  void set_reorder_curve(sfc::curve curve);
+
+    /**
+    * Reorders the faces (by their centre) and the vertices along the selected space-filling curve so that faces that are
+    * close in space are close in memory and in the MPI partitions. Called by from_json and from_hdf5 prior to partitioning.
+    */
+  void reorder_by_curve();
+
     /**
     * Sets the MPI process ownership of mesh faces and nodes
     */
   void partition_mesh();
 
+    /**
+    * Selects how partition_mesh divides the faces between the MPI processes. Defaults to partitioner::method::block.
+    * Must be set before from_json or from_hdf5.
+    * \param method
+    */
+  void set_partition_method(partitioner::method method);
+
+    /**
+    * Weights each face by the value of a parameter when partitioning, e.g., a per-face cost measured in an earlier run.
+    * Must be set before from_json or from_hdf5.
+    * \param parameter
+    */
+  void set_partition_weight(const std::string& parameter);
+
+    /**
+    * Logs the owned faces, ghost neighbors and communication volume of every MPI process
+    */
+  void report_partition();
+
     /**
     * Figures out which faces lie on the boundary of an MPI process' domain
     */
@@ -726,6 +847,47 @@ public:
 	 */
     std::vector< mesh_elem > find_faces_in_radius(double x, double y, double radius) const;
 
+    /**
+     * Walks a straight ray from the centre of start along a bearing, face to face through the neighbor links, calling
+     * visit for each face crossed in order (starting with start, entry = 0). The cost is linear in the number of faces
+     * crossed and, as it only follows neighbors, it works on any process that holds the faces along the path.
+     * The walk ends at max_distance, at the edge of the mesh (or of the faces loaded by this process), or when visit
+     * returns false, e.g., once a horizon has been found.
+     * @code
+     *       double phi = 0;
+     *       domain->walk_ray(face, azimuth, 1000., [&](const ray_hit& hit)
+     *       {
+     *           ...
+     *           return phi < solar_el; // keep walking until shadowed
+     *       });
+     * @endcode
+     * @param start Face to start from
+     * @param bearing Degrees, CW from north
+     * @param max_distance [m]
+     * @param visit Callable as bool(const ray_hit&)
+     */
+    template<typename Visitor>
+    void walk_ray(mesh_elem start, double bearing, double max_distance, Visitor visit) const;
+
+    /**
+     * Horizon angles of the local faces in nsectors azimuth sectors, found by walking a ray out to max_distance in each.
+     * Computed on first request and shared by every caller asking for the same sectors and distance. If the mesh
+     * cache is in use the map is also cached on disk next to it. Call from a module's init, not concurrently.
+     * @param nsectors
+     * @param max_distance [m]
+     * @return
+     */
+    std::shared_ptr<const horizon_map> horizon(size_t nsectors, double max_distance);
+
+    /**
+     * Returns the faces crossed by a ray, see walk_ray above
+     * @param start Face to start from
+     * @param bearing Degrees, CW from north
+     * @param max_distance [m]
+     * @return Faces crossed in order, starting with start
+     */
+    std::vector<ray_hit> walk_ray(mesh_elem start, double bearing, double max_distance) const;
+
     /**
      * Lcoates the triangle that contains the query point. Guaranteed that if a triangle is found, the point lies inside the triangle.
      *
@@ -793,10 +955,46 @@ public:
      */
     void init_vtkUnstructured_Grid(std::vector<std::string> output_variables);
 
-    /// Initializes all the face timeseries to hold the selected variables
+    /// Initializes the variable store to hold the selected variables for all local faces and ghost neighbors
     /// @param variables
     void init_timeseries(std::set< std::string > variables);
 
+    /// Columnar per-face variable storage, indexed by face->cell_local_id.
+    /// Rows [0, size_faces()) are the locally owned faces, followed by the ghost neighbors.
+    /// @return
+    columnstorage<double>& variable_store();
+
+    /// Flat per-face geometry (centroid, normal, slope, aspect, area, edges, neighbors), indexed by face->cell_local_id
+    /// with the same rows as the variable store. Built once when the mesh is loaded.
+    /// @return
+    const face_geometry& geometry() const;
+
+    /// (Re)computes the geometry table from the faces. Called at the end of the mesh load.
+    void build_geometry();
+
+    /// The forcing stations, in the order station values are given to station_weights()
+    /// @return
+    const std::vector< std::shared_ptr<station> >& stations() const;
+
+    /// Static weights from each face's stations to the face centre, rows indexed by face->cell_local_id for the local
+    /// faces. Inverse distance, or bilinear for the bilinear_grid interpolant. Built by build_station_weights.
+    /// @return
+    const idw_weights& station_weights() const;
+
+    /// Sets the forcing stations and computes station_weights() from the faces' station lists. Call once the station
+    /// lists are populated.
+    /// @param stations All the stations the faces may refer to
+    /// @param ia If bilinear_grid, each face's stations are the corners of its forcing grid cell, in grid order, and
+    /// the bilinear weights are used. Otherwise inverse distance.
+    void build_station_weights(const std::vector< std::shared_ptr<station> >& stations, interp_alg ia = interp_alg::idw);
+
+    /// Resolves a variable to a handle into the variable store. Use _s for compile-time hash.
+    /// Throws if the variable does not exist.
+    /// @param variable
+    /// @return
+    column_handle resolve_variable(const uint64_t& variable);
+    column_handle resolve_variable(const std::string& variable);
+
     /// Initializes the face vectors
     /// @param variables
     void init_vectors(std::set<std::string>& variables);
@@ -817,6 +1015,7 @@ public:
 
 	/**
 	 * Updates the internal vtk structure with this timesteps data.
+	 * Only the variables and vectors are updated; parameters and geometry are written when the vtk structure is built.
 	 * Must be called prior to calling the write_vt* functions.
 	 * The write_vt* functions could call this, however it makes them not threadsafe.
 	 * If output_variables is empty, it will write all variables out
@@ -829,6 +1028,19 @@ public:
     */
 	void write_vtu(std::string fname);
 
+    /**
+     * Returns a copy of the internal vtk mesh that is safe to write from another thread while the model continues.
+     * The geometry, point data and field data are shared with the internal mesh as they are not modified between
+     * calls to update_vtk_data. The cell data arrays are deep copied.
+     * update_vtk_data must be called first.
+     */
+    vtkSmartPointer<vtkUnstructuredGrid> vtk_snapshot();
+
+    /**
+     * Saves a vtk mesh, e.g., from vtk_snapshot, to a vtu file
+     */
+    static void write_vtu(vtkSmartPointer<vtkUnstructuredGrid> grid, std::string fname);
+
 
 	/**
 	 * Returns true if this is a geogrphic mesh
@@ -900,10 +1112,12 @@ private:
 #ifdef USE_SPARSEHASH
     google::dense_hash_map< std::string, vtkSmartPointer<vtkFloatArray>  > data;
     google::dense_hash_map< std::string, vtkSmartPointer<vtkFloatArray>  > vectors;
+    google::dense_hash_map< std::string, vtkSmartPointer<vtkFloatArray>  > static_data;
     google::dense_hash_map< std::string, vtkSmartPointer<vtkFloatArray>  > vertex_data;
 #else
 	std::map<std::string, vtkSmartPointer<vtkFloatArray> > data;
 	std::map<std::string, vtkSmartPointer<vtkFloatArray> > vectors;
+	std::map<std::string, vtkSmartPointer<vtkFloatArray> > static_data; // parameters, ics and geometry. Written once in init_vtkUnstructured_Grid
         std::map<std::string, vtkSmartPointer<vtkFloatArray> > vertex_data;
 #endif
 
@@ -912,6 +1126,19 @@ private:
     //should we write ghost neighbor faces to the vtu file?
     bool _write_ghost_neighbors_to_vtu;
 
+    // per-face variables for the local faces and ghost neighbors, indexed by cell_local_id
+    columnstorage<double> _variable_store;
+
+    // precomputed per-face geometry, same rows as _variable_store
+    face_geometry _geometry;
+
+    // horizon maps by (sectors, distance)
+    std::map<std::pair<size_t, double>, std::shared_ptr<horizon_map>> _horizons;
+
+    // mesh cache this mesh was read from or written to, if any. Derived data (e.g., horizons) is cached next to it
+    std::string _cache_path;
+    uint64_t _cache_hash;
+
     // min and max elevations
     double _min_z;
     double _max_z;
@@ -958,7 +1185,24 @@ private:
 
     std::vector<int> _global_IDs;
 
+    // space-filling curve to reorder the faces and vertices with at load
+    sfc::curve _reorder_curve;
+    // the row in the hdf5 files of each face, indexed by cell_global_id. Empty if the faces are in file order
+    std::vector<size_t> _file_face_index;
+
+    // only read the owned and halo faces in from_hdf5
+    bool _distributed_load;
+
+    // how faces are divided between MPI processes
+    partitioner::method _partition_method;
+    // parameter used to weight the faces in the partition, or empty
+    std::string _partition_weight_parameter;
+    // weight of each face, indexed by cell_global_id, if it can't be read from the faces (hdf5 parameters are read after partitioning)
+    std::vector<double> _partition_weights;
+
+  // forcing stations and the inverse distance weights from them to the faces
   std::vector< std::shared_ptr<station> > _stations;
+  idw_weights _station_weights;
 
 #ifdef NOMATLAB
     //ptr to the matlab engine
@@ -1187,8 +1431,8 @@ face<Gt, Fb>::face()
     _slope = -1;
     _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
+    _has_center = false;
+    _has_normal = false;
     _area = -1.;
     _is_geographic = false;
 
@@ -1205,8 +1449,8 @@ face<Gt, Fb>::face(Vertex_handle v0,
     _slope = -1;
     _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
+    _has_center = false;
+    _has_normal = false;
     _area = -1.;
     _is_geographic = false;
 
@@ -1224,8 +1468,8 @@ face<Gt, Fb>::face(Vertex_handle v0,
     _slope = -1;
     _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
+    _has_center = false;
+    _has_normal = false;
     _area = -1.;
     _is_geographic = false;
 
@@ -1246,8 +1490,8 @@ face<Gt, Fb>::face(Vertex_handle v0,
     _slope = -1;
     _azimuth = -1;
     _data = boost::make_shared<timeseries>();
-    _center = NULL;
-    _normal = NULL;
+    _has_center = false;
+    _has_normal = false;
     _area = -1.;
     _is_geographic = false;
 
@@ -1259,10 +1503,10 @@ double face<Gt, Fb>::aspect()
 {
     if (_azimuth == -1)
     {
-        if(!_normal)
+        if(!_has_normal)
             this->normal();
 
-        _azimuth = math::gis::cartesian_to_bearing(Vector_2((*_normal)[0],(*_normal)[1])) * M_PI/180.; //need in radians
+        _azimuth = math::gis::cartesian_to_bearing(Vector_2(_normal[0],_normal[1])) * M_PI/180.; //need in radians
 
     }
 
@@ -1332,7 +1576,7 @@ double face<Gt, Fb>::slope()
 {
     if (_slope == -1)
     {
-        if(!_normal)
+        if(!_has_normal)
             this->normal();
 
         //z surface normal
@@ -1342,9 +1586,9 @@ double face<Gt, Fb>::slope()
         n(2) = 1.0;
 
         arma::vec normal(3);
-        normal(0) = (*_normal)[0];
-        normal(1) = (*_normal)[1];
-        normal(2) = (*_normal)[2];
+        normal(0) = _normal[0];
+        normal(1) = _normal[1];
+        normal(2) = _normal[2];
 
         _slope = acos(arma::norm_dot(normal, n));
     }
@@ -1378,7 +1622,7 @@ const typename face<Gt, Fb>::Face_handle face<Gt, Fb>::find_closest_face(double
 template < class Gt, class Fb>
 Vector_3 face<Gt, Fb>::normal()
 {
-    if(!_normal)
+    if(!_has_normal)
     {
         if(_is_geographic)
         {
@@ -1393,11 +1637,13 @@ Vector_3 face<Gt, Fb>::normal()
             CGAL::Point_3<K> v1(this->vertex(1)->point()[0]*100000., this->vertex(1)->point()[1]*100000.,this->vertex(1)->point()[2]);
             CGAL::Point_3<K> v2(this->vertex(2)->point()[0]*100000., this->vertex(2)->point()[1]*100000.,this->vertex(2)->point()[2]);
 
-            _normal = boost::make_shared<Vector_3>(CGAL::unit_normal(v0, v1, v2));
+            _normal = CGAL::unit_normal(v0, v1, v2);
 
         }
         else
-            _normal = boost::make_shared<Vector_3>(CGAL::unit_normal(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point()));
+            _normal = CGAL::unit_normal(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
+
+        _has_normal = true;
     }
 
 //    CGAL::Point_3<K> v0(this->vertex(0)->point()[0]*100000., this->vertex(0)->point()[1]*100000.,this->vertex(0)->point()[2]);
@@ -1410,23 +1656,41 @@ Vector_3 face<Gt, Fb>::normal()
 //
 //    CGAL::Exact_predicates_exact_constructions_kernel::Vector_3 un1 = CGAL::unit_normal(v0_noscale, v1_noscale, v2_noscale);
 //    Vector_3 un2 = CGAL::unit_normal(v0, v1, v2);
-    return *_normal;
+    return _normal;
 }
 
 template < class Gt, class Fb>
 Point_3 face<Gt, Fb>::center()
 {
-    if (!_center)
+    if (!_has_center)
     {
-        _center = boost::make_shared<Point_3>(CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point()));
-        _x=_center->x();
-        _y=_center->y();
-        _z=_center->z();
+        _center = CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
+        _has_center = true;
+        _x=_center.x();
+        _y=_center.y();
+        _z=_center.z();
     }
     //return CGAL::centroid(this->vertex(0)->point(), this->vertex(1)->point(), this->vertex(2)->point());
-    return *_center;
+    return _center;
 
 }
+template < class Gt, class Fb>
+void face<Gt, Fb>::set_geometry(const Point_3& center, const Vector_3& normal, double slope, double aspect, double area)
+{
+    _center = center;
+    _has_center = true;
+    _x=_center.x();
+    _y=_center.y();
+    _z=_center.z();
+
+    _normal = normal;
+    _has_normal = true;
+
+    _slope = slope;
+    _azimuth = aspect;
+    _area = area;
+}
+
 template < class Gt, class Fb>
 bool face<Gt, Fb>::contains(Point_3 p)
 {
@@ -1462,34 +1726,44 @@ bool face<Gt, Fb>::contains(double x, double y)
 template < class Gt, class Fb>
 std::vector<std::string> face<Gt, Fb>::variables()
 {
+    if(cell_local_id >= _domain->variable_store().rows())
+        return std::vector<std::string>();
 
-    return _variables.variables();
+    return _domain->variable_store().variables();
 }
 
 
 template < class Gt, class Fb>
 bool face<Gt, Fb>::has(const std::string& variable)
 {
-    return _variables.has(variable);
+    return cell_local_id < _domain->variable_store().rows() &&
+           _domain->variable_store().has(variable);
 
 };
 
 template < class Gt, class Fb>
 bool face<Gt, Fb>::has(const uint64_t& hash)
 {
-    return _variables.has(hash);
+    return cell_local_id < _domain->variable_store().rows() &&
+           _domain->variable_store().has(hash);
 }
 
 template < class Gt, class Fb>
 double& face<Gt, Fb>::operator[](const uint64_t& hash)
 {
-     return _variables[hash];
+     return _domain->variable_store().at(hash, cell_local_id);
 }
 
 template < class Gt, class Fb>
 double& face<Gt, Fb>::operator[](const std::string& variable)
 {
-    return _variables[variable];
+    return _domain->variable_store().at(variable, cell_local_id);
+}
+
+template < class Gt, class Fb>
+double& face<Gt, Fb>::operator[](const column_handle& variable)
+{
+    return _domain->variable_store()(variable, cell_local_id);
 }
 
 template < class Gt, class Fb >
@@ -1535,10 +1809,16 @@ Vector_3 face<Gt, Fb>::face_vector(const std::string& variable)
 };
 
 template < class Gt, class Fb>
-void face<Gt, Fb>::init_time_series(std::set<std::string>& variables)
+typename face<Gt, Fb>::vector_handle face<Gt, Fb>::resolve_face_vector(const std::string& variable)
 {
-    _variables.init(variables);
-}
+    return _module_face_vectors.resolve(variable);
+};
+
+template < class Gt, class Fb>
+Vector_3 face<Gt, Fb>::face_vector(const vector_handle& variable)
+{
+    return _module_face_vectors[variable];
+};
 
 template < class Gt, class Fb>
 void face<Gt, Fb>::init_vectors(std::set<std::string>& variables)
@@ -1586,7 +1866,7 @@ void face<Gt, Fb>::to_file(std::string fname)
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_x()
 {
-    if(!_center)
+    if(!_has_center)
         this->center();
 
     return _x;
@@ -1595,7 +1875,7 @@ double face<Gt, Fb>::get_x()
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_y()
 {
-    if(!_center)
+    if(!_has_center)
         this->center();
 
 
@@ -1605,7 +1885,7 @@ double face<Gt, Fb>::get_y()
 template < class Gt, class Fb>
 double face<Gt, Fb>::get_z()
 {
-    if(!_center)
+    if(!_has_center)
         this->center();
 
     return _z;
@@ -1724,6 +2004,89 @@ double face<Gt, Fb>::get_subgrid_z(Point_2 query)
 
 };
 
+template<typename Visitor>
+void triangulation::walk_ray(mesh_elem start, double bearing, double max_distance, Visitor visit) const
+{
+    Point_3 origin = start->center();
+
+    // direction of the ray in the mesh's coordinates. For geographic meshes a degree of longitude shrinks with latitude
+    double b = bearing * M_PI / 180.;
+    double dx = sin(b);
+    double dy = cos(b);
+    if (_is_geographic)
+        dx /= cos(origin.y() * M_PI / 180.);
+
+    // metres per unit of the ray parameter
+    const double h = 1e-3;
+    double scale = math::gis::distance(origin, Point_3(origin.x() + dx * h, origin.y() + dy * h, origin.z())) / h;
+    double t_max = max_distance / scale;
+
+    mesh_elem f = start;
+    double t_in = 0;
+
+    // the faces form a convex partition so the ray always leaves through the nearest outward facing edge. The count
+    // guards against cycling on degenerate (e.g., through a vertex) crossings
+    for (size_t n = 0; f != nullptr && t_in <= t_max && n <= _faces.size(); ++n)
+    {
+        double t_out = std::numeric_limits<double>::max();
+        int exit_edge = -1;
+        for (int j = 0; j < 3; ++j)
+        {
+            auto normal = f->edge_unit_normal(j);
+            double dn = dx * normal.x() + dy * normal.y();
+            if (dn <= 0)
+                continue;
+
+            auto& p = f->vertex(ccw(j))->point();
+            double t = ((p.x() - origin.x()) * normal.x() + (p.y() - origin.y()) * normal.y()) / dn;
+            if (t < t_out)
+            {
+                t_out = t;
+                exit_edge = j;
+            }
+        }
+
+        if (exit_edge == -1)
+            break;
+
+        t_out = std::max(t_out, t_in);
+
+        ray_hit hit{f, t_in * scale, std::min(t_out, t_max) * scale};
+        if (!visit(hit))
+            break;
+
+        f = f->neighbor(exit_edge);
+        t_in = t_out;
+    }
+}
+
+template < class Gt, class Fb>
+template<typename Visitor>
+void face<Gt, Fb>::walk_ray(double bearing, double max_distance, Visitor visit)
+{
+    // A face doesn't hold its own handle, but its neighbors link back to it. Looking it up by cell_local_id would only
+    // be right for local faces, not ghosts.
+    for (int j = 0; j < 3; j++)
+    {
+        auto n = this->neighbor(j);
+        if (n == nullptr)
+            continue;
+
+        for (int k = 0; k < 3; k++)
+        {
+            auto self = n->neighbor(k);
+            if (self != nullptr && &*self == this)
+            {
+                _domain->walk_ray(self, bearing, max_distance, visit);
+                return;
+            }
+        }
+    }
+
+    // no neighbors, so a single face mesh and this is local
+    _domain->walk_ray(_domain->face(cell_local_id), bearing, max_distance, visit);
+}
+
 template <typename T>
 T determine_owner_of_global_index(T index, std::vector<T> num_faces_in_partition)
 {
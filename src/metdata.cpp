@@ -22,6 +22,7 @@
 //
 
 #include "metdata.hpp"
+#include "bilinear.hpp"
 
 metdata::metdata(std::string mesh_proj4)
 {
@@ -30,6 +31,8 @@ metdata::metdata(std::string mesh_proj4)
     _n_timesteps = 0;
     _mesh_proj4 = mesh_proj4;
     is_first_timestep = true;
+    _prefetch = false;
+    _prefetch_stop = false;
 
     OGRSpatialReference srs;
     srs.importFromProj4(_mesh_proj4.c_str());
@@ -38,7 +41,15 @@ metdata::metdata(std::string mesh_proj4)
 
 metdata::~metdata()
 {
-
+    if(_prefetch_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_prefetch_mutex);
+            _prefetch_stop = true;
+        }
+        _prefetch_cv.notify_one();
+        _prefetch_thread.join();
+    }
 }
 
 void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boost::shared_ptr<filter_base> > filters)
@@ -151,6 +162,8 @@ void metdata::load_from_netcdf(const std::string& path,std::map<std::string, boo
     delete coordTrans;
     _dt = _nc->get_dt();
 
+    update_nc_window();
+
     _current_ts = _start_time;
 }
 
@@ -332,6 +345,8 @@ void metdata::subset(boost::posix_time::ptime start, boost::posix_time::ptime en
     {
         CHM_THROW_EXCEPTION(forcing_error,"dt = 0");
     }
+    cancel_prefetch();
+
     // the netcdf files are simple and don't need this subsetting
     if(!_use_netcdf)
     {
@@ -421,35 +436,139 @@ std::shared_ptr<station> metdata::at(size_t idx)
 
 bool metdata::next()
 {
+    PROFILE_SCOPE("metdata::next");
+
     bool has_next = false;
 
     // allows for doing first timestep loading without incrementing the timestep
     if(!is_first_timestep)
         _current_ts = _current_ts + _dt;
 
-    if(_use_netcdf)
+    if(_prefetch_result.valid())
+    {
+        // already read in the background, wait for it and swap it in
+        has_next = _prefetch_result.get();
+        if(has_next)
+        {
+            for(size_t i = 0; i < nstations(); i++)
+            {
+                _stations[i]->swap_timestep_data(*_prefetch_stations[i]);
+                _stations[i]->set_posix(_current_ts);
+            }
+        }
+    }
+    else if(_use_netcdf)
     {
-        has_next = next_nc();
+        has_next = next_nc(_current_ts, _stations, true);
     }
     else
     {
-        has_next = next_ascii();
+        has_next = next_ascii(_current_ts, _stations, is_first_timestep);
     }
 
     is_first_timestep = false;
+
+    if(_prefetch && has_next)
+        start_prefetch();
+
     return has_next;
 }
 
-bool metdata::next_ascii()
+void metdata::enable_prefetch(bool prefetch)
 {
+    _prefetch = prefetch;
+}
 
-    for(size_t i = 0; i < nstations();i++)
+void metdata::start_prefetch()
+{
+    // stations may have been pruned since we last made the shadow copies
+    if(_prefetch_stations.size() != _stations.size())
     {
-        auto s = _stations.at(i);
+        _prefetch_stations.clear();
+        for(auto& s : _stations)
+        {
+            auto vars = s->variables();
+            auto p = std::make_shared<station>(s->ID(), s->x(), s->y(), s->z(),
+                                               std::set<std::string>(vars.begin(), vars.end()));
+            p->_nc_x = s->_nc_x;
+            p->_nc_y = s->_nc_y;
+            _prefetch_stations.push_back(p);
+        }
+    }
+
+    auto ts = _current_ts + _dt;
+    std::packaged_task<bool()> task([this, ts]()
+                                    {
+                                        // the modules own the OpenMP threads while this runs, so read serially
+                                        if(_use_netcdf)
+                                            return next_nc(ts, _prefetch_stations, false);
+                                        else
+                                            return next_ascii(ts, _prefetch_stations, false);
+                                    });
+    _prefetch_result = task.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(_prefetch_mutex);
+        _prefetch_task = std::move(task);
+
+        if(!_prefetch_thread.joinable())
+            _prefetch_thread = std::thread(&metdata::prefetch_worker, this);
+    }
+    _prefetch_cv.notify_one();
+}
+
+void metdata::prefetch_worker()
+{
+    while(true)
+    {
+        std::packaged_task<bool()> task;
+        {
+            std::unique_lock<std::mutex> lock(_prefetch_mutex);
+            _prefetch_cv.wait(lock, [this]{ return _prefetch_task.valid() || _prefetch_stop; });
+
+            if(!_prefetch_task.valid())
+                break;
+
+            task = std::move(_prefetch_task);
+        }
+
+        // a failed read is rethrown from the future on the model thread
+        PROFILE_SCOPE("metdata::prefetch");
+        task();
+    }
+}
+
+void metdata::wait_prefetch()
+{
+    if(_prefetch_result.valid())
+        _prefetch_result.wait();
+}
+
+void metdata::cancel_prefetch()
+{
+    if(_prefetch_result.valid())
+    {
+        try
+        {
+            _prefetch_result.get();
+        }
+        catch(...)
+        {
+            // we don't want this timestep anyway
+        }
+    }
+}
+
+bool metdata::next_ascii(boost::posix_time::ptime ts, std::vector< std::shared_ptr<station>>& stations, bool first)
+{
+
+    for(size_t i = 0; i < stations.size();i++)
+    {
+        auto s = stations.at(i);
         auto& proxy = _ascii_stations[s->ID()];
 
         //the very first timestep needs to handle loading the data without incrementing the internal iterators
-        if(!is_first_timestep)
+        if(!first)
         {
             ++proxy->_itr;
             if (proxy->_itr == proxy->_obs.end())
@@ -457,11 +576,11 @@ bool metdata::next_ascii()
         }
 
 
-        if(proxy->_itr->get_posix() != _current_ts)
+        if(proxy->_itr->get_posix() != ts)
         {
             CHM_THROW_EXCEPTION(forcing_error,
                 "Mismatch between model timestep and ascii file timestep. Current model = " +
-                boost::posix_time::to_simple_string(_current_ts) + ", ascii was:"+
+                boost::posix_time::to_simple_string(ts) + ", ascii was:"+
                 boost::posix_time::to_simple_string(proxy->_itr->get_posix()) +" @station id="+s->ID());
         }
 
@@ -480,34 +599,46 @@ bool metdata::next_ascii()
             filt->process(s);
         }
 
-        s->set_posix(_current_ts);
+        s->set_posix(ts);
 
     }
 
     return true;
 }
-bool metdata::next_nc()
+bool metdata::next_nc(boost::posix_time::ptime ts, std::vector< std::shared_ptr<station>>& stations, bool parallel)
 {
-    if(_current_ts > _end_time) //_current_ts is already ++ from the next() call
+    if(ts > _end_time)
     {
         return false; // we've run out of data, we done
     }
 
 
-    //The call to netCDF isn't thread safe. It is protected by a critical section but it's costly, and not running this
-    // in parallel is about 2x faster  #pragma omp parallel for
-    for(size_t i = 0; i < nstations();i++)
+    // Read each variable's window as one slab, then scatter to the stations. One read per variable instead of one per
+    // station per variable.
+    // don't use the stations variable map as it'll contain anything inserted by a filter which won't exist in the nc file
+    for (auto &v: _nc->get_variable_names() )
     {
-        auto s = _stations.at(i);
-        s->set_posix(_current_ts);
+        if(stations.empty())
+            break;
 
-        // don't use the stations variable map as it'll contain anything inserted by a filter which won't exist in the nc file
-        for (auto &v: _nc->get_variable_names() )
-        {
-            double d = _nc->get_var(v, _current_ts, s->_nc_x, s->_nc_y);
-            (*s)[v] = d;
+        auto slab = _nc->get_var_window(v, ts,
+                                        _nc_window.x_start, _nc_window.y_start,
+                                        _nc_window.nx, _nc_window.ny);
 
+        #pragma omp parallel for if(parallel)
+        for(size_t i = 0; i < stations.size();i++)
+        {
+            auto& s = stations[i];
+            size_t x = static_cast<size_t>(s->_nc_x) - _nc_window.x_start;
+            size_t y = static_cast<size_t>(s->_nc_y) - _nc_window.y_start;
+            (*s)[v] = slab[y][x];
         }
+    }
+
+    for(size_t i = 0; i < stations.size();i++)
+    {
+        auto s = stations.at(i);
+        s->set_posix(ts);
 
         // run all the filters for this station
         for (auto& f : _netcdf_filters)
@@ -553,6 +684,71 @@ std::vector< std::shared_ptr<station> > metdata::nearest_station(double x, doubl
 
 }
 
+std::vector< std::shared_ptr<station> > metdata::grid_cell(double x, double y)
+{
+    if(!_use_netcdf)
+    {
+        CHM_THROW_EXCEPTION(config_error, "Gridded interpolation requires NetCDF forcing.");
+    }
+
+    long nx = _nc->get_xsize();
+    long ny = _nc->get_ysize();
+
+    if(nx < 2 || ny < 2)
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "Gridded interpolation requires a NetCDF grid of at least 2x2.");
+    }
+
+    // stations are indexed as x + y*nx until they are pruned
+    if(_stations.size() != static_cast<size_t>(nx * ny))
+    {
+        CHM_THROW_EXCEPTION(forcing_error, "Grid cells are not available after the stations have been pruned.");
+    }
+
+    // the closest grid point is a corner of the cell, check the up to 4 cells that share it
+    auto closest = nearest_station(x, y).at(0);
+    long i = static_cast<long>(closest->_nc_x);
+    long j = static_cast<long>(closest->_nc_y);
+
+    std::vector< std::shared_ptr<station> > cell;
+    double best = std::numeric_limits<double>::max();
+
+    for (long cj = j - 1; cj <= j; cj++)
+    {
+        for (long ci = i - 1; ci <= i; ci++)
+        {
+            if(ci < 0 || cj < 0 || ci + 1 >= nx || cj + 1 >= ny)
+                continue;
+
+            std::vector< std::shared_ptr<station> > corners = {_stations[ci + cj * nx],
+                                                               _stations[ci + 1 + cj * nx],
+                                                               _stations[ci + (cj + 1) * nx],
+                                                               _stations[ci + 1 + (cj + 1) * nx]};
+
+            double cx[4], cy[4];
+            for (size_t k = 0; k < 4; k++)
+            {
+                cx[k] = corners[k]->x();
+                cy[k] = corners[k]->y();
+            }
+
+            double u, v;
+            if(bilinear::cell_coordinates(cx, cy, x, y, u, v))
+                return corners;
+
+            // off the grid, or the closest grid point isn't a corner of the containing cell in a warped grid
+            double d = std::max({0., -u, u - 1.}) + std::max({0., -v, v - 1.});
+            if(d < best)
+            {
+                best = d;
+                cell = corners;
+            }
+        }
+    }
+
+    return cell;
+}
+
 void metdata::prune_stations(std::unordered_set<std::string>& station_ids)
 {
     _stations.erase(
@@ -564,6 +760,40 @@ void metdata::prune_stations(std::unordered_set<std::string>& station_ids)
         std::end(_stations));
 
     _nstations = _stations.size();
+
+    if(_use_netcdf)
+        update_nc_window();
+}
+
+void metdata::update_nc_window()
+{
+    if(_stations.empty())
+    {
+        _nc_window = {0, 0, 0, 0};
+        return;
+    }
+
+    size_t x_min = std::numeric_limits<size_t>::max();
+    size_t y_min = std::numeric_limits<size_t>::max();
+    size_t x_max = 0;
+    size_t y_max = 0;
+
+    for(auto& s : _stations)
+    {
+        size_t x = static_cast<size_t>(s->_nc_x);
+        size_t y = static_cast<size_t>(s->_nc_y);
+        x_min = std::min(x_min, x);
+        y_min = std::min(y_min, y);
+        x_max = std::max(x_max, x);
+        y_max = std::max(y_max, y);
+    }
+
+    _nc_window.x_start = x_min;
+    _nc_window.y_start = y_min;
+    _nc_window.nx = x_max - x_min + 1;
+    _nc_window.ny = y_max - y_min + 1;
+
+    LOG_DEBUG << "NetCDF read window is x=[" << x_min << "," << x_max << "], y=[" << y_min << "," << y_max << "] for " << _stations.size() << " stations";
 }
 
 std::vector< std::shared_ptr<station>>& metdata::stations()
@@ -38,6 +38,12 @@
 #include <set>
 #include <unordered_set>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 //boost includes
 #include <boost/function.hpp>
@@ -62,6 +68,7 @@
 #include "timeseries.hpp"
 #include "triangulation.hpp"
 #include "filter_base.hpp"
+#include "utility/profiler.hpp"
 /**
  * Main meteorological data coordinator. Opens from a variety of sources and ensures that each virtual station has this timestep's information
  * regardless of the source data type.
@@ -131,6 +138,16 @@ class metdata
      */
     std::vector< std::shared_ptr<station> > nearest_station(double x, double y,unsigned int N=1);
 
+    /**
+     * Returns the 4 corners of the NetCDF grid cell containing x,y, in grid order (i,j), (i+1,j), (i,j+1), (i+1,j+1).
+     * The cell is found in grid index space from the closest grid point. If x,y is off the grid, the closest cell.
+     * Only valid for NetCDF forcing, and prior to pruning the stations.
+     * @param x
+     * @param y
+     * @return
+     */
+    std::vector< std::shared_ptr<station> > grid_cell(double x, double y);
+
     /// Return a list of stations for a point x,y corresponding to a search radius, or nearest station
     boost::function< std::vector< std::shared_ptr<station> > ( double, double) > get_stations;
 
@@ -173,9 +190,19 @@ class metdata
     size_t dt_seconds();
 
     /// Populates the stations' with the next timesteps' value.
+    /// If prefetching is enabled, this swaps in the values read in the background and starts reading the following timestep.
     /// @return False if no more timesteps
     bool next();
 
+    /// If enabled, the timestep following the current one is read and filtered in a background thread while the
+    /// current timestep is computed. Must be set prior to the first call to next().
+    /// @param prefetch
+    void enable_prefetch(bool prefetch);
+
+    /// Blocks until any outstanding background read is done, e.g., before writing other NetCDF files. The result is
+    /// kept for the next call to next().
+    void wait_prefetch();
+
     /// Removes a subset of stations from the  station list
     /// @param stations The set of station IDs to remove
     void prune_stations(std::unordered_set<std::string>& station_ids);
@@ -202,13 +229,31 @@ class metdata
         timeseries::iterator _itr;
     };
 
-    /// Advances 1 timestep in the netcdf files
-    bool next_nc();
+    /// Loads timestep ts from the netcdf files into stations
+    /// @param ts
+    /// @param stations Either _stations, or the prefetch stations
+    /// @param parallel Allow an OpenMP parallel scatter
+    bool next_nc(boost::posix_time::ptime ts, std::vector< std::shared_ptr<station>>& stations, bool parallel);
 
+    /// Recomputes the bounding window of the netcdf grid cells used by the current stations
+    void update_nc_window();
 
-    /// Advances 1 timestep from the ascii timeseries
+
+    /// Advances 1 timestep from the ascii timeseries into stations
+    /// @param ts
+    /// @param stations Either _stations, or the prefetch stations
+    /// @param first If true, the internal iterators are not incremented
     /// @return
-    bool next_ascii();
+    bool next_ascii(boost::posix_time::ptime ts, std::vector< std::shared_ptr<station>>& stations, bool first);
+
+    /// Starts reading _current_ts + dt into _prefetch_stations in the background
+    void start_prefetch();
+
+    /// Blocks until any outstanding prefetch is done, discarding the result
+    void cancel_prefetch();
+
+    /// Runs the prefetch reads on _prefetch_thread, one at a time
+    void prefetch_worker();
 
     /// For all the stations loaded from ascii files, find the latest start time, and the earliest end time that is consistent across all stations
     /// @return
@@ -225,6 +270,15 @@ class metdata
 
         std::set<std::string> _provides_from_nc_filters;
 
+        // bounding window, in grid cells, of the stations we need. Each variable is read as one slab of this window per timestep
+        struct
+        {
+            size_t x_start;
+            size_t y_start;
+            size_t nx;
+            size_t ny;
+        } _nc_window;
+
         // if false, we are using ascii files
         bool _use_netcdf;
 
@@ -249,6 +303,25 @@ class metdata
 
     bool is_first_timestep;
 
+    // Prefetching
+    // -----------------------------------
+        bool _prefetch;
+
+        // shadow copy of _stations that the background read fills. Its values are swapped into _stations on next()
+        std::vector< std::shared_ptr<station>> _prefetch_stations;
+
+        // result of the background read for _current_ts + dt
+        std::future<bool> _prefetch_result;
+
+        // the reads all run on one long lived thread, started by the first prefetch, rather than a new thread per
+        // timestep. _prefetch_task is the read waiting to be picked up
+        std::thread _prefetch_thread;
+        std::mutex _prefetch_mutex;
+        std::condition_variable _prefetch_cv;
+        std::packaged_task<bool()> _prefetch_task;
+        bool _prefetch_stop;
+    // -----------------------------------
+
     //number of timesteps
     size_t _n_timesteps;
 
@@ -36,13 +36,27 @@ Marsh_shading_iswr::Marsh_shading_iswr(config_file cfg)
 
     x_AABB = cfg.get<int>("x_AABB",10);
     y_AABB = cfg.get<int>("y_AABB",10);
+
+    std::string backend = cfg.get("backend","aabb");
+    if(backend != "aabb" && backend != "zbuffer")
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("Marsh_shading_iswr: unknown backend " + backend + ". Expected aabb or zbuffer."));
+
+    use_zbuffer = backend == "zbuffer";
+    resolution = cfg.get<size_t>("resolution",2048);
+
+    if(use_zbuffer)
+        provides("shadow_fraction");
     LOG_DEBUG << "Successfully instantiated module " << this->ID;
 
 }
 
 void Marsh_shading_iswr::run(mesh& domain)
 {
-
+    if(use_zbuffer)
+    {
+        run_zbuffer(domain);
+        return;
+    }
 
     //compute the rotation of each vertex
 
@@ -217,6 +231,77 @@ void Marsh_shading_iswr::run(mesh& domain)
 
 }
 
+void Marsh_shading_iswr::run_zbuffer(mesh& domain)
+{
+    PROFILE_SCOPE("Marsh_shading_iswr zbuffer");
+
+    size_t nvert = domain->size_vertex();
+    size_t nface = domain->size_faces();
+
+    // the sun position is the same over the domain for the purposes of the projection, take it from the first face
+    double A = (*domain->face(0))["solar_az"_s];
+    double E = (*domain->face(0))["solar_el"_s];
+
+    // rotate into arrays so the triangulation is left untouched
+    std::vector<double> x(nvert), y(nvert), z(nvert);
+    std::unordered_map<size_t, int> vertex_index;
+    vertex_index.reserve(nvert);
+
+    // euler rotation matrix K, eqns(6) & (7) in Montero
+    double z0 = M_PI - A * M_PI / 180.0;
+    double q0 = M_PI / 2.0 - E * M_PI / 180.0;
+    double K[3][3] = {{cos(z0), sin(z0), 0},
+                      {-cos(q0) * sin(z0), cos(q0) * cos(z0), sin(q0)},
+                      {sin(q0) * sin(z0), -cos(z0) * sin(q0), cos(q0)}};
+
+    for (size_t i = 0; i < nvert; i++)
+    {
+        auto vert = domain->vertex(i);
+        vertex_index[vert->get_id()] = i;
+
+        double px = vert->point().x();
+        double py = vert->point().y();
+        double pz = vert->point().z();
+
+        x[i] = K[0][0] * px + K[0][1] * py + K[0][2] * pz;
+        y[i] = K[1][0] * px + K[1][1] * py + K[1][2] * pz;
+        z[i] = K[2][0] * px + K[2][1] * py + K[2][2] * pz;
+    }
+
+    std::vector<std::array<int, 3>> triangles(nface);
+#pragma omp parallel for
+    for (size_t i = 0; i < nface; i++)
+    {
+        auto face = domain->face(i);
+        for (int j = 0; j < 3; j++)
+            triangles[i][j] = vertex_index.at(face->vertex(j)->get_id());
+    }
+
+    math::depth_buffer buffer(x, y, z, triangles, resolution);
+    buffer.render();
+
+    // allow for the depth of a triangle varying across a pixel
+    auto fraction = buffer.occluded_fraction(buffer.pixel_size());
+
+#pragma omp parallel for
+    for (size_t i = 0; i < nface; i++)
+    {
+        auto face = domain->face(i);
+        if ((*face)["solar_el"_s] < 5)
+        {
+            (*face)["z_prime"_s] = 0; //unshadowed
+            (*face)["shadow"_s] = 0;
+            (*face)["shadow_fraction"_s] = 0;
+            continue;
+        }
+
+        const auto& t = triangles[i];
+        (*face)["z_prime"_s] = (z[t[0]] + z[t[1]] + z[t[2]]) / 3.0;
+        (*face)["shadow"_s] = fraction[i] >= 0.5 ? 1 : 0;
+        (*face)["shadow_fraction"_s] = fraction[i];
+    }
+}
+
 Marsh_shading_iswr::~Marsh_shading_iswr()
 {
 
@@ -26,10 +26,13 @@
 #include "logger.hpp"
 #include "triangulation.hpp"
 #include "module_base.hpp"
+#include "math/depth_buffer.hpp"
 
 #include <cstdlib>
 #include <string>
 #include <utility> //for pair
+#include <unordered_map>
+#include <array>
 #include <vector>
 #include <cmath>
 #include <armadillo>
@@ -71,6 +74,7 @@ struct vertex_data : vertex_info
  * **Provides:**
  * - Value that provides a metric for triangle 'nearness' to the sun "z_prime" [-]
  * - Binary shadow value "shadowed" [1 (true) / 0 (false)]
+ * - Fraction of the triangle that is shadowed "shadow_fraction" [-], only with the ``zbuffer`` backend
  *
  * **Configuration:**
  *
@@ -78,8 +82,10 @@ struct vertex_data : vertex_info
  * .. code:: json
  *
  *    {
+ *       "backend":"aabb",
  *       "x_AABB":10,
- *       "y_AABB":10
+ *       "y_AABB":10,
+ *       "resolution":2048
  *    }
  *
  *
@@ -103,6 +109,25 @@ struct vertex_data : vertex_info
  *
  *    This is the size number of bins in the y direction.
  *
+ * .. confval:: backend
+ *
+ *    :type: string
+ *    :default: "aabb"
+ *
+ *    How the occlusion is computed in the projected space. ``aabb`` compares the triangles within each bin, as described
+ *    above. ``zbuffer`` instead renders the projected mesh into a depth buffer, as done for shadow mapping in computer
+ *    graphics, and a triangle is shadowed if more than half of the pixels it covers are closer to the sun. This scales
+ *    linearly with the number of triangles and provides the partial shadowing of each triangle as "shadow_fraction".
+ *    ``x_AABB`` and ``y_AABB`` are not used with ``zbuffer``.
+ *
+ * .. confval:: resolution
+ *
+ *    :type: int
+ *    :default: 2048
+ *
+ *    Number of depth buffer pixels along the longer side of the projected domain, for the ``zbuffer`` backend. The
+ *    pixels should be smaller than the smallest triangles of interest, as triangles are only resolved to a pixel.
+ *
  * \endrst
  * Reference:
  * - Marsh, C.B., J.W. Pomeroy, and R.J. Spiteri. “Implications of Mountain Shading on Calculating Energy for Snowmelt
@@ -118,6 +143,13 @@ REGISTER_MODULE_HPP(Marsh_shading_iswr);
 
     int x_AABB;
     int y_AABB;
+
+    // use the depth buffer instead of the AABB comparisons
+    bool use_zbuffer;
+    size_t resolution;
+
+  private:
+    void run_zbuffer(mesh& domain);
 };
 
 /**
@@ -385,6 +385,9 @@ void PBSM3D::run(mesh& domain)
     size_t ntri = domain->size_faces();
     size_t n_global_tri = domain->size_global_faces();
 
+    // flat per-face geometry for the stencils
+    auto& geo = domain->geometry();
+
     suspension_NNP->zeroSystem();
     deposition_NNP->zeroSystem();
 
@@ -862,7 +865,7 @@ void PBSM3D::run(mesh& domain)
                 uvw(0) = v.x(); // U_x
                 uvw(1) = v.y(); // U_y
                 uvw(2) = 0;
-                double V = face->get_area();
+                double V = geo.area[id];
                 double udotm[3] = {0, 0, 0};
                 double E[3] = {0, 0, 0};
 
@@ -872,7 +875,7 @@ void PBSM3D::run(mesh& domain)
                 for (int j = 0; j < 3; ++j)
                 {
                     udotm[j] = arma::dot(uvw, d->m[j]);
-                    E[j] = face->edge_length(j);
+                    E[j] = geo.edge_length[id][j];
                     mass += -E[j] * Qsalt * udotm[j];
                 }
 
@@ -1196,7 +1199,7 @@ void PBSM3D::run(mesh& domain)
                 // lateral
                 int idx = n_global_tri * z + face->cell_global_id;
 
-                double V = face->get_area() * v_edge_height;
+                double V = geo.area[id] * v_edge_height;
                 // the sink term is added on for each edge check, which isn't right
                 // and ends up 5x counting it so / by 5 for V so it's
                 // not 5x counted.
@@ -1479,6 +1482,7 @@ void PBSM3D::run(mesh& domain)
     for (size_t i = 0; i < domain->size_faces(); i++)
     {
         auto face = domain->face(i);
+        auto id = face->cell_local_id;
         auto d = face->get_module_data<data>(ID);
         auto& m = d->m;
 
@@ -1495,7 +1499,7 @@ void PBSM3D::run(mesh& domain)
         double E[3] = {0, 0, 0};        // edge lengths b/c 2d now
         double dx[3] = {2.0, 2.0, 2.0}; // cell centre distances
 
-        double V = face->get_area(); // V for consistency but actually an area
+        double V = geo.area[id]; // V for consistency but actually an area
 
 	int local_row, global_row, local_col, global_col;
 	global_row = static_cast<int>(face->cell_global_id);
@@ -1508,7 +1512,7 @@ void PBSM3D::run(mesh& domain)
         {
             // just unit vectors as qsusp/qsalt flux has magnitude
             udotm[j] = arma::dot(uvw, m[j]);
-            E[j] = face->edge_length(j);
+            E[j] = geo.edge_length[id][j];
 
             double Qtj = 0;
             double Qsj = 0;
@@ -1547,7 +1551,7 @@ void PBSM3D::run(mesh& domain)
             {
                 auto neigh = face->neighbor(j);
 		global_col = static_cast<int>(neigh->cell_global_id);
-                dx[j] = math::gis::distance(face->center(), neigh->center());
+                dx[j] = geo.neighbor_distance[id][j];
 
 		// diagonal entry
 		deposition_NNP->matrixSumIntoGlobalValues(global_row, global_row, eps * E[j] / dx[j]);
@@ -32,13 +32,24 @@ fast_shadow::fast_shadow(config_file cfg)
     depends("solar_el");
     provides("shadow");
 
-    //number of steps along the search vector to check for a higher point
-    steps = cfg.get("steps",10);
     //max distance to search
     max_distance = cfg.get("max_distance",1000.0);
 
-    //size of the step to take
-    size_of_step = max_distance / steps;
+    use_horizon_map = cfg.get("horizon_map",true);
+    nsectors = cfg.get("nsectors",72);
+}
+
+void fast_shadow::init(mesh& domain)
+{
+    // precomputed horizons would keep the shadows of the initial terrain
+    if(use_horizon_map && !global_param->is_static_terrain())
+    {
+        LOG_WARNING << "The terrain changes during the run, fast_shadow will search along the solar azimuth every timestep instead of using a horizon map";
+        use_horizon_map = false;
+    }
+
+    if(use_horizon_map)
+        horizon = domain->horizon(nsectors, max_distance);
 }
 
 fast_shadow::~fast_shadow()
@@ -59,34 +70,34 @@ void fast_shadow::run(mesh_elem& face)
 
     double solar_az = (*face)["solar_az"_s] ;
 
+    // the terrain is static so the horizon is a lookup between the two sectors either side of the sun
+    if (horizon)
+    {
+        if (horizon->angle_at(face->cell_local_id, solar_az) > solar_el)
+            (*face)["shadow"_s]= 1;
+        return;
+    }
+
     Point_3 me = face->center();
 
     double phi = 0.;
-    // search along each azimuth in j step increments to find horizon angle
-    for (int j = 1; j <= steps; ++j)
+    // walk along the solar azimuth face by face to find the horizon angle, stopping once the sun is below it
+    face->walk_ray(solar_az, max_distance, [&](const ray_hit& hit)
     {
-        double distance = j * size_of_step;
-
-        auto f = face->find_closest_face(solar_az, distance);
-
+        auto f = hit.face;
         double z_diff = f->center().z() - me.z() ;
-        if (z_diff > 0)
+        if (f != face && z_diff > 0)
         {
             double dist = math::gis::distance(f->center(), me);
             phi = std::max(atan(z_diff / dist), phi);
         }
-        //try to bail early if possible
-        if (phi > solar_el )
-        {
-            (*face)["shadow"_s]= 1;
-        }
-    }
-    //try to bail early if possible
+
+        return phi <= solar_el;
+    });
+
     if (phi > solar_el )
     {
         (*face)["shadow"_s]= 1;
     }
 
-
-
 }
@@ -50,18 +50,12 @@
  * .. code:: json
  *
  *    {
- *       "steps": 10,
- *       "max_distance": 1000
+ *       "max_distance": 1000,
+ *       "horizon_map": true,
+ *       "nsectors": 72
  *    }
  *
  *
- * .. confval:: steps
- *
- *    :type: int
- *    :default: 10
- *
- *    Number of steps along the search vector to check for a higher point
- *
  * .. confval:: max_distance
  *
  *    :type: double
@@ -69,6 +63,24 @@
  *
  *    Maximum search distance to look for a higher point
  *
+ * .. confval:: horizon_map
+ *
+ *    :type: bool
+ *    :default: true
+ *
+ *    Computes the horizon of every face in ``nsectors`` azimuth sectors once at init, after which the shadow is a
+ *    lookup interpolated between the two sectors either side of the solar azimuth. The map is shared with the
+ *    sky view factor in ``solar`` if it uses the same sectors and distance, and is cached next to the mesh cache if
+ *    one is used. If the terrain changes during the run, i.e., with ``deform_mesh``, the map is not used and the
+ *    shadow is found by searching along the solar azimuth every timestep instead.
+ *
+ * .. confval:: nsectors
+ *
+ *    :type: int
+ *    :default: 72
+ *
+ *    Number of azimuth sectors in the horizon map
+ *
  * \endrst
  *
  * **References:**
@@ -90,12 +102,14 @@ public:
 
     virtual void run(mesh_elem& face);
 
-//number of steps along the search vector to check for a higher point
-    int steps;
+    void init(mesh& domain);
+
     //max distance to search
     double max_distance;
 
-    //size of the step to take
-    double size_of_step;
+    //precomputed horizons, if used
+    bool use_horizon_map;
+    size_t nsectors;
+    std::shared_ptr<const horizon_map> horizon;
 
 };
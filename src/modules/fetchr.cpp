@@ -32,20 +32,19 @@ fetchr::fetchr(config_file cfg)
 
     provides("fetch");
 
-    //number of steps along the search vector to check for a higher point
-    steps = cfg.get("steps",10);
     //max distance to search
     max_distance = cfg.get("max_distance",1000.0);
 
-    //size of the step to take
-    size_of_step = max_distance / steps;
-
     I = cfg.get("I",0.06);
 
     incl_veg = cfg.get("incl_veg",true);
 
     h_IBL = 5;
 
+    nsectors = cfg.get<size_t>("nsectors",0);
+    for(size_t k = 0; k < nsectors; k++)
+        provides_parameter("fetch_sector_" + std::to_string(k));
+
 }
 
 fetchr::~fetchr()
@@ -54,15 +53,95 @@ fetchr::~fetchr()
 
 }
 
-void fetchr::run(mesh_elem& face)
+void fetchr::init(mesh& domain)
 {
+    if(nsectors == 0)
+        return;
+
+    size_t nfaces = domain->size_faces();
+    sector_fetch.resize(nfaces * nsectors);
+
+    // use the sectors from the parameters if they were loaded with the mesh
+    bool loaded = true;
+    for(size_t i = 0; i < nfaces && loaded; i++)
+    {
+        auto face = domain->face(i);
+        for(size_t k = 0; k < nsectors; k++)
+        {
+            double fetch = face->parameter("fetch_sector_" + std::to_string(k));
+            if(fetch == -9999. || std::isnan(fetch))
+            {
+                loaded = false;
+                break;
+            }
+            sector_fetch[i * nsectors + k] = fetch;
+        }
+    }
+
+    if(loaded)
+    {
+        LOG_DEBUG << "Using fetch sectors from the mesh parameters";
+        return;
+    }
 
+    LOG_DEBUG << "Computing fetch for " << nsectors << " wind direction sectors";
 
-    (*face)["fetch"_s]= max_distance;
+#pragma omp parallel for
+    for(size_t i = 0; i < nfaces; i++)
+    {
+        auto face = domain->face(i);
+        for(size_t k = 0; k < nsectors; k++)
+        {
+            double fetch = compute_fetch(face, k * 360.0 / nsectors);
+            sector_fetch[i * nsectors + k] = fetch;
+            face->parameter("fetch_sector_" + std::to_string(k)) = fetch;
+        }
+    }
 
+    std::string write_sectors = cfg.get("write_sectors","");
+    if(!write_sectors.empty())
+    {
+        if(domain->size_faces() != domain->size_global_faces())
+        {
+            LOG_WARNING << "fetchr: write_sectors requires a single process run, the sectors were not written";
+        }
+        else
+        {
+            std::vector<std::string> names;
+            for(size_t k = 0; k < nsectors; k++)
+                names.push_back("fetch_sector_" + std::to_string(k));
+
+            domain->write_parameters_hdf5(write_sectors, names);
+            LOG_DEBUG << "Wrote fetch sectors to " << write_sectors;
+        }
+    }
+}
+
+void fetchr::run(mesh_elem& face)
+{
     //direction it is from, need upwind fetch
     double wind_dir = (*face)["vw_dir"_s] ;
 
+    if(nsectors > 0)
+    {
+        // interpolate between the sectors either side of the wind direction
+        double s = fmod(fmod(wind_dir, 360.0) + 360.0, 360.0) / (360.0 / nsectors);
+        size_t k0 = static_cast<size_t>(s) % nsectors;
+        size_t k1 = (k0 + 1) % nsectors;
+        double w = s - floor(s);
+
+        const double* fetch = &sector_fetch[face->cell_local_id * nsectors];
+        (*face)["fetch"_s] = (1 - w) * fetch[k0] + w * fetch[k1];
+        return;
+    }
+
+    (*face)["fetch"_s] = compute_fetch(face, wind_dir);
+}
+
+double fetchr::compute_fetch(mesh_elem& face, double wind_dir)
+{
+    double fetch = max_distance;
+
     //if we are using vegetation and the current face is covered in veg, set the fetch to 0
     if(incl_veg && face->has_vegetation())
     {
@@ -70,18 +149,23 @@ void fetchr::run(mesh_elem& face)
         double me_Z_CanTop = face->veg_attribute("CanopyHeight");
         if(me_Z_CanTop > 1) // 1m might be too high?
         {
-            (*face)["fetch"_s]= 0;
-            return;
+            return 0;
         }
 
     }
 
-    // search along wind_dir azimuth in j step increments
-    for (int j = 1; j <= steps; ++j)
+    double Z_me = face->center().z();
+
+    // walk upwind along the wind_dir azimuth face by face until the fetch is broken
+    face->walk_ray(wind_dir, max_distance, [&](const ray_hit& hit)
     {
-        double distance = j * size_of_step;
+        if (hit.face == face)
+            return true;
 
-        auto f = face->find_closest_face(wind_dir, distance);
+        // the nearest point of this face along the search vector
+        double distance = hit.entry;
+
+        auto f = hit.face;
 
         double Z_CanTop = 0;
         if (incl_veg && f->has_vegetation())
@@ -94,7 +178,7 @@ void fetchr::run(mesh_elem& face)
         double Z_test =  f->center().z()+Z_CanTop;
 
         //equation 1, pg 771, Lapen and Martz 1993
-        double Z_core = face->center().z() + distance*I;
+        double Z_core = Z_me + distance*I;
 
         double z0_1 = 0.12*Z_CanTop;
         double z0_2 = 0.001;
@@ -109,12 +193,12 @@ void fetchr::run(mesh_elem& face)
         if(Z_test >= Z_core ||
                 (incl_veg && distance < x_sss) )
         {
-            (*face)["fetch"_s]= distance;
-            break;
+            fetch = distance;
+            return false;
         }
-    }
-
-
 
+        return true;
+    });
 
+    return fetch;
 }
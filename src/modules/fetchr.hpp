@@ -48,18 +48,10 @@
  * .. code:: json
  *
  *    {
- *       "steps": 10,
  *       "max_distance": 1000
  *    }
  *
  *
- * .. confval:: steps
- *
- *    :type: int
- *    :default: 10
- *
- *    Number of steps along the search vector to check for a higher point
- *
  * .. confval:: max_distance
  *
  *    :type: double
@@ -74,6 +66,25 @@
  *
  *    Rise/run threshold to multiply against the distance of a test triangle.
  *
+ * .. confval:: nsectors
+ *
+ *    :type: int
+ *    :default: 0
+ *
+ *    If > 0, the fetch of every face is computed at init for this many wind direction sectors and the fetch at each
+ *    timestep is interpolated between the two sectors either side of the wind direction, instead of searching upwind
+ *    every timestep. The sectors are provided as the parameters ``fetch_sector_<k>`` for the sector centred on
+ *    ``k*360/nsectors`` degrees. If these are already in the mesh parameters, e.g., from the parameter hdf5, they are
+ *    used and not recomputed.
+ *
+ * .. confval:: write_sectors
+ *
+ *    :type: string
+ *    :default: ""
+ *
+ *    If set, and ``nsectors`` > 0, the sector fetches are written to this hdf5 parameter file so later runs can add it
+ *    to the mesh's parameter files. Only possible for a single process run.
+ *
  * \endrst
  *
  * **References:**
@@ -92,13 +103,14 @@ public:
 
     virtual void run(mesh_elem& face);
 
-//number of steps along the search vector to check for a higher point
-    int steps;
+    virtual void init(mesh& domain);
+
+    // searches upwind from the face for the fetch distance
+    double compute_fetch(mesh_elem& face, double wind_dir);
+
     //max distance to search
     double max_distance;
     double h_IBL; // IBL depth to reestablish steady state (5m to fit blowins snow assumption)
-    //size of the step to take
-    double size_of_step;
 
     bool incl_veg;
 
@@ -106,4 +118,8 @@ public:
     //0.06 m/m corresponds to prarie shelter belts
     double I;
 
+    // per face fetch for each wind direction sector, row-major by cell_local_id. Empty if not used
+    size_t nsectors;
+    std::vector<double> sector_fetch;
+
 };
@@ -101,18 +101,19 @@ void Cullen_monthly_llra_ta::run(mesh_elem& face)
 
 
     //lower all the station values to sea level prior to the interpolation
-    std::vector< boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["t"_s]))
             continue;
         double v = (*s)["t"_s] - lapse_rate * (0.0 - s->z());
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
+        lowered_values.push_back(s->x(), s->y(), v);
     }
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double value = face->get_module_data<data>(ID)->interp(lowered_values, query);
+    double value = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);
 
     //raise value back up to the face's elevation from sea level
     value =  value + lapse_rate * (0.0 - face->get_z());
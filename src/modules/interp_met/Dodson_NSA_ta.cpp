@@ -62,7 +62,8 @@ void Dodson_NSA_ta::run(mesh_elem &face)
     double lapse = 0.0065; //K/m
 
     //lower all the station values to sea level prior to the interpolation
-    std::vector< boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
 
 
     for (auto& s : face->stations())
@@ -80,13 +81,13 @@ void Dodson_NSA_ta::run(mesh_elem &face)
         double exp = R/(m*Cp);
         double theta = ta * pow(ratio,exp);
 
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), theta ) );
+        lowered_values.push_back(s->x(), s->y(), theta);
     }
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
 
     //interpolated virtual temp, now go back to station
-    double theta = face->get_module_data<data>(ID)->interp(lowered_values, query);
+    double theta = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);
     double elev = face->get_z();
     double Pz = Po * pow(Tb/(Tb+ (-lapse)*elev),(m*g)/((-lapse)*R));
     double ratio = (Po/Pz);
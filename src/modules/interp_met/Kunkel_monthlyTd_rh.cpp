@@ -82,7 +82,8 @@ void Kunkel_monthlyTd_rh::run(mesh_elem& face)
     const double Bi = 22.452, Ci = 272.55; //parameters for ice
 
     //lower all the station values to sea level prior to the interpolation
-    std::vector< boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["t"_s]) || is_nan((*s)["rh"_s]))
@@ -101,13 +102,13 @@ void Kunkel_monthlyTd_rh::run(mesh_elem& face)
         double am = lapse;
 //        double Td_z = -lapse*C*(z-z0) / B + Tdz0;
         double Td_z = (-am/B*(z-z0)*(C+Tdz0)/B+Tdz0)/(1+am*(z-z0)*(C+Tdz0)/(B*C));
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), Td_z ) );
+        lowered_values.push_back(s->x(), s->y(), Td_z);
     }
 
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double Tdz0 = face->get_module_data<data>(ID)->interp(lowered_values, query);//C
+    double Tdz0 = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);//C
 
     //raise value back up to the face's elevation from sea level
     double t = (*face)["t"_s] + 273.15;
@@ -170,36 +170,78 @@ void Liston_wind::run(mesh& domain)
     // omega_s needs to be scaled on [-0.5,0.5]
     double max_omega_s = -99999.0;
 
+    // with idw or bilinear, the station winds are interpolated to all the faces at once using the static weights
+    bool batched = global_param->interp_algorithm == interp_alg::idw ||
+                   global_param->interp_algorithm == interp_alg::bilinear_grid;
+    std::vector<double> batched_uv; // [face][u,v]
+    if (batched)
+    {
+        auto& stations = domain->stations();
+        std::vector<double> station_uv(stations.size() * 2);
+        for (size_t j = 0; j < stations.size(); j++)
+        {
+            auto& s = stations[j];
+            if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+            {
+                station_uv[j*2] = station_uv[j*2+1] = std::numeric_limits<double>::quiet_NaN();
+                continue;
+            }
+
+            double W = std::max((*s)["U_R"_s], 0.1);
+            double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+
+            station_uv[j*2] = -W * sin(theta); //negate as it needs to be the direction the wind is *going*
+            station_uv[j*2+1] = -W * cos(theta);
+        }
+
+        batched_uv.resize(domain->size_faces() * 2);
+        domain->station_weights().interpolate(station_uv.data(), 2, batched_uv.data());
+    }
+
     #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
     {
 
         auto face = domain->face(i);
 
-        std::vector<boost::tuple<double, double, double> > u;
-        std::vector<boost::tuple<double, double, double> > v;
-        for (auto &s : face->stations())
-        {
-           if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
-             continue;
-
-           double W = (*s)["U_R"_s];
-           W = std::max(W, 0.1);
+        double zonal_u = 0;
+        double zonal_v = 0;
 
-           double theta = (*s)["vw_dir"_s] * M_PI / 180.;
-           double phi = math::gis::bearing_to_polar((*s)["vw_dir"_s] );
-
-           double zonal_u = -W * sin(theta);//negate as it needs to be the direction the wind is *going*
-           double zonal_v = -W * cos(theta);
-
-           u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
-           v.push_back(boost::make_tuple(s->x(), s->y(), zonal_v));
+        if (batched)
+        {
+            zonal_u = batched_uv[face->cell_local_id*2];
+            zonal_v = batched_uv[face->cell_local_id*2+1];
+        }
+        else
+        {
+            static thread_local interp_samples samples; // zonal u and v, interpolated together
+            samples.clear();
+            for (auto &s : face->stations())
+            {
+               if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
+                 continue;
+
+               double W = (*s)["U_R"_s];
+               W = std::max(W, 0.1);
+
+               double theta = (*s)["vw_dir"_s] * M_PI / 180.;
+               double phi = math::gis::bearing_to_polar((*s)["vw_dir"_s] );
+
+               double station_u = -W * sin(theta);//negate as it needs to be the direction the wind is *going*
+               double station_v = -W * cos(theta);
+
+               samples.push_back(s->x(), s->y());
+               samples.values.push_back(station_u);
+               samples.values.push_back(station_v);
+            }
+            //http://mst.nerc.ac.uk/wind_vect_convs.html
+
+            auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
+            double interpolated[2];
+            face->get_module_data<lwinddata>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+            zonal_u = interpolated[0];
+            zonal_v = interpolated[1];
         }
-        //http://mst.nerc.ac.uk/wind_vect_convs.html
-
-        auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-        double zonal_u = face->get_module_data<lwinddata>(ID)->interp(u, query);
-        double zonal_v = face->get_module_data<lwinddata>(ID)->interp(v, query);
 
         double theta = 3.0 * M_PI * 0.5 - atan2(zonal_v, zonal_u);
         //        double theta = atan2(-zonal_v, -zonal_u);
@@ -303,19 +345,20 @@ void Liston_wind::run(mesh& domain)
     {
 
         auto face = domain->face(i);
-        std::vector<boost::tuple<double, double, double> > u;
+        static thread_local interp_samples u;
+        u.clear();
         for (size_t j = 0; j < 3; j++)
         {
            auto neigh = face->neighbor(j);
            if (neigh != nullptr)
-             u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), (*neigh)["U_R"_s]));
+             u.push_back(neigh->get_x(), neigh->get_y(), (*neigh)["U_R"_s]);
         }
 
         double new_u = (*face)["U_R"_s];
         if(u.size() > 0)
         {
            auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-           new_u = face->get_module_data<lwinddata>(ID)->interp_smoothing(u, query);
+           new_u = face->get_module_data<lwinddata>(ID)->interp_smoothing(u.view(), query);
         }
 
         face->get_module_data<lwinddata>(ID)->temp_u = new_u;
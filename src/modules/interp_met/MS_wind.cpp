@@ -63,19 +63,63 @@ void MS_wind::init(mesh& domain)
          d->interp.init(global_param->interp_algorithm,face->stations().size() );
          d->interp_smoothing.init(interp_alg::tpspline,3,{ {"reuse_LU","true"}});
     }
+
+    // load the library into a flat table, resolving the parameter names once
+    std::vector<std::string> names;
+    for(int d = 0; d < n_directions; d++)
+    {
+        names.push_back("MS" + std::to_string(d));
+        names.push_back("MS" + std::to_string(d) + "_U");
+        names.push_back("MS" + std::to_string(d) + "_V");
+    }
+
+    // the u,v method uses MS0..MS7 with their _U and _V, the Ryan method the speedups MS1..MS8
+    std::vector<std::string> required;
+    for(int d = use_ryan_dir ? 1 : 0; d < (use_ryan_dir ? 9 : 8); d++)
+    {
+        required.push_back("MS" + std::to_string(d));
+        if(!use_ryan_dir)
+        {
+            required.push_back("MS" + std::to_string(d) + "_U");
+            required.push_back("MS" + std::to_string(d) + "_V");
+        }
+    }
+    for(auto& param : required)
+    {
+        if(domain->size_faces() > 0 && !domain->face(0)->has_parameter(param))
+            CHM_THROW_EXCEPTION(module_error, "MS_wind: Missing parameter: " + param);
+    }
+
+    library.resize(domain->size_faces() * names.size());
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < domain->size_faces(); i++)
+    {
+        auto face = domain->face(i);
+        for(size_t k = 0; k < names.size(); k++)
+        {
+            library[face->cell_local_id * names.size() + k] =
+                face->has_parameter(names[k]) ? face->parameter(names[k]) : nan("");
+        }
+    }
 }
 
 
 void MS_wind::run(mesh& domain)
 {
+    // the smoothing stencils read the neighbors' geometry and U_R by row
+    auto& geo = domain->geometry();
+    auto& store = domain->variable_store();
+    auto U_R = domain->resolve_variable("U_R"_s);
+
     if(!use_ryan_dir)
     {
         #pragma omp parallel for
         for (size_t i = 0; i < domain->size_faces(); i++)
         {
             auto face = domain->face(i);
-		     std::vector<boost::tuple<double, double, double> > u;
-		     std::vector<boost::tuple<double, double, double> > v;
+		     static thread_local interp_samples samples; // zonal u and v, interpolated together
+		     samples.clear();
 		     for (auto &s : face->stations())
 		     {
 		       if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
@@ -94,16 +138,19 @@ void MS_wind::run(mesh& domain)
 		       double zonal_u = -W * sin(theta);
 		       double zonal_v = -W * cos(theta);
 
-		       u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
-		       v.push_back(boost::make_tuple(s->x(), s->y(), zonal_v));
+		       samples.push_back(s->x(), s->y());
+		       samples.values.push_back(zonal_u);
+		       samples.values.push_back(zonal_v);
 		     }
 
 		     //http://mst.nerc.ac.uk/wind_vect_convs.html
 
 		     // get an interpolated zonal U,V at our face
 		     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-		     double zonal_u = face->get_module_data<data>(ID)->interp(u, query);
-		     double zonal_v = face->get_module_data<data>(ID)->interp(v, query);
+		     double interpolated[2];
+		     face->get_module_data<data>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+		     double zonal_u = interpolated[0];
+		     double zonal_v = interpolated[1];
 
 		     (*face)["interp_zonal_u"_s]= zonal_u;
 		     (*face)["interp_zonal_v"_s]= zonal_v;
@@ -122,9 +169,10 @@ void MS_wind::run(mesh& domain)
 		     (*face)["lookup_d"_s]= d;
 
 		     // get the speedup for the interpolated direction
-		     double U_speedup = face->parameter("MS" + std::to_string(d) + "_U");
-		     double V_speedup = face->parameter("MS" + std::to_string(d) + "_V");
-		     double W_speedup = face->parameter("MS" + std::to_string(d));
+		     const double* lib = speedup(face->cell_local_id, d);
+		     double U_speedup = lib[1];
+		     double V_speedup = lib[2];
+		     double W_speedup = lib[0];
 
 		     // Speed up interpolated zonal_u & zonal_v
 		     double W = sqrt(zonal_u * zonal_u + zonal_v * zonal_v) * W_speedup;
@@ -170,23 +218,23 @@ void MS_wind::run(mesh& domain)
         for (size_t i = 0; i < domain->size_faces(); i++)
         {
           auto face = domain->face(i);
+          auto row = face->cell_local_id;
 
-          std::vector<boost::tuple<double, double, double>> u;
+          static thread_local interp_samples u;
+          u.clear();
           for (size_t j = 0; j < 3; j++)
           {
-            auto neigh = face->neighbor(j);
-            if (neigh != nullptr)
-              u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),
-                                            (*neigh)["U_R"_s]));
+            int n = geo.neighbor[row][j];
+            if (n >= 0)
+              u.push_back(geo.x[n], geo.y[n], store(U_R, n));
           }
 
-          double new_u = (*face)["U_R"_s];
+          double new_u = store(U_R, row);
 
           if (u.size() > 0)
           {
-            auto query =
-                boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-            new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
+            auto query = boost::make_tuple(geo.x[row], geo.y[row], geo.z[row]);
+            new_u = face->get_module_data<data>(ID)->interp_smoothing(u.view(), query);
           }
 
           face->get_module_data<data>(ID)->temp_u = new_u;
@@ -212,8 +260,8 @@ void MS_wind::run(mesh& domain)
         {
             auto face = domain->face(i);
 
-             std::vector<boost::tuple<double, double, double> > u;
-             std::vector<boost::tuple<double, double, double> > v;
+             static thread_local interp_samples samples; // zonal u and v, interpolated together
+             samples.clear();
              for (auto &s : face->stations())
              {
                if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
@@ -225,9 +273,11 @@ void MS_wind::run(mesh& domain)
                //figure out which lookup map we need
                int d = int(theta*180/M_PI/45.);
                if (d == 0) d = 8;
-               double speedup = f->parameter("MS"+std::to_string(d));
+               // the closest face may be a ghost, which isn't held in the library
+               double W_speedup = f->cell_local_id < domain->size_faces() ?
+                                    speedup(f->cell_local_id, d)[0] : f->parameter("MS"+std::to_string(d));
 
-               double W = (*s)["U_R"_s] / speedup;
+               double W = (*s)["U_R"_s] / W_speedup;
                W = std::max(W, 0.1);
                W = Atmosphere::log_scale_wind(W,
                                               Atmosphere::Z_U_R,  // UR is at our reference height
@@ -238,14 +288,17 @@ void MS_wind::run(mesh& domain)
                double zonal_u = -W * sin(theta);
                double zonal_v = -W * cos(theta);
 
-               u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
-               v.push_back(boost::make_tuple(s->x(), s->y(), zonal_v));
+               samples.push_back(s->x(), s->y());
+               samples.values.push_back(zonal_u);
+               samples.values.push_back(zonal_v);
              }
              //http://mst.nerc.ac.uk/wind_vect_convs.html
 
              auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-             double zonal_u = face->get_module_data<data>(ID)->interp(u, query);
-             double zonal_v = face->get_module_data<data>(ID)->interp(v, query);
+             double interpolated[2];
+             face->get_module_data<data>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+             double zonal_u = interpolated[0];
+             double zonal_v = interpolated[1];
 
              double theta = 3.0 * M_PI * 0.5 - atan2(zonal_v, zonal_u);
 
@@ -253,7 +306,7 @@ void MS_wind::run(mesh& domain)
                theta = theta - 2.0 * M_PI;
 
              //eqn 15
-             double omega_s = face->slope() * cos(theta - face->aspect());
+             double omega_s = geo.slope[face->cell_local_id] * cos(theta - geo.aspect[face->cell_local_id]);
 
              if (fabs(omega_s) > max_omega_s)
                max_omega_s = fabs(omega_s);
@@ -270,20 +323,21 @@ void MS_wind::run(mesh& domain)
         for (size_t i = 0; i < domain->size_faces(); i++)
         {
             auto face = domain->face(i);
+            auto row = face->cell_local_id;
 
 
 		     double theta= face->get_module_data<data>(ID)->corrected_theta;
 		     double W= face->get_module_data<data>(ID)->W;
 
 		     //what liston calls 'wind slope'
-		     double omega_s = face->slope() * cos(theta - face->aspect());
+		     double omega_s = geo.slope[row] * cos(theta - geo.aspect[row]);
 
 		     //scale between [-0.5,0.5]
 		     omega_s = omega_s / (max_omega_s * 2.0);
 
 		     //scale wind here via MS
 
-		     double aspect = face->aspect();
+		     double aspect = geo.aspect[row];
 		     double dirdiff = 0;
 
 		     double d2r = M_PI/180.0;
@@ -312,8 +366,7 @@ void MS_wind::run(mesh& domain)
 		     int d = int(theta*180.0/M_PI/45.);
 		     if (d == 0) d = 8;
 
-		     double speedup = face->parameter("MS"+std::to_string(d));
-		     W = W*speedup;
+		     W = W*speedup(row, d)[0];
 
 		     W = std::max(W,0.1);
 		     W = std::min(W,30.0);
@@ -343,21 +396,23 @@ void MS_wind::run(mesh& domain)
         {
 
             auto face = domain->face(i);
+            auto row = face->cell_local_id;
 
-		     std::vector<boost::tuple<double, double, double> > u;
+		     static thread_local interp_samples u;
+		     u.clear();
 		     for (size_t j = 0; j < 3; j++)
 		     {
-		       auto neigh = face->neighbor(j);
-		       if (neigh != nullptr)
-			 u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),(*neigh)["U_R"_s]));
+		       int n = geo.neighbor[row][j];
+		       if (n >= 0)
+			 u.push_back(geo.x[n], geo.y[n], store(U_R, n));
 		     }
 
 
-		     double new_u = (*face)["U_R"_s];
+		     double new_u = store(U_R, row);
 		     if (u.size() > 0)
 		     {
-		       auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-		       new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
+		       auto query = boost::make_tuple(geo.x[row], geo.y[row], geo.z[row]);
+		       new_u = face->get_module_data<data>(ID)->interp_smoothing(u.view(), query);
 		     }
 
 		     face->get_module_data<data>(ID)->temp_u = new_u;
@@ -115,4 +115,15 @@ public:
     double distance;
     bool use_ryan_dir;
     double speedup_height; // height at which the speedup is for
+
+    // The MS speedup library, loaded from the parameters at init so the timestep doesn't look up parameters by name.
+    // Laid out [face][direction][component] by cell_local_id for the directions MS0..MS8, with components
+    // 0 = speedup, 1 = U, 2 = V. Directions or components missing from the parameters are nan
+    static const int n_directions = 9;
+    std::vector<double> library;
+
+    inline const double* speedup(size_t row, int d) const
+    {
+        return &library[(row * n_directions + d) * 3];
+    }
 };
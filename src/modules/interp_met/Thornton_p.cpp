@@ -59,21 +59,24 @@ void Thornton_p::run(mesh_elem& face)
     {
         mf /= 1000.0; //to m^-1
     }
-    std::vector< boost::tuple<double, double, double> > ppt;
-    std::vector< boost::tuple<double, double, double> > staion_z;
+    static thread_local interp_samples samples; // precipitation and station elevation, interpolated together
+    samples.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["p"_s]))
             continue;
         double u = (*s)["p"_s];
-        ppt.push_back( boost::make_tuple(s->x(), s->y(), u ) );
-        staion_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
+        samples.push_back(s->x(), s->y());
+        samples.values.push_back(u);
+        samples.values.push_back(s->z());
     }
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double p0 = face->get_module_data<data>(ID)->interp(ppt, query);
-    double z0 = face->get_module_data<data>(ID)->interp(staion_z,query);
+    double interpolated[2];
+    face->get_module_data<data>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+    double p0 = interpolated[0];
+    double z0 = interpolated[1];
     double z = face->get_z();
     double slp = face->slope();
 
@@ -261,6 +261,29 @@ void WindNinja::init(mesh& domain)
 
         Sx = boost::dynamic_pointer_cast<Winstral_parameters>(module_factory::create("Winstral_parameters",tmp));
     }
+
+    // load the library into a flat table, resolving the parameter names once
+    std::vector<uint64_t> names;
+    for(int d = 1; d <= N_windfield; d++)
+    {
+        std::vector<std::string> component = {
+            L_avg == -1 ? "Ninja" + std::to_string(d) : "Ninja" + std::to_string(d) + '_' + std::to_string(L_avg), // transfert function
+            "Ninja" + std::to_string(d) + "_U", // zonal component
+            "Ninja" + std::to_string(d) + "_V"}; // meridional component
+
+        for(auto& c : component)
+            names.push_back(xxh64::hash(c.c_str(), c.length()));
+    }
+
+    library.resize(domain->size_faces() * names.size());
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < domain->size_faces(); i++)
+    {
+        auto face = domain->face(i);
+        for(size_t k = 0; k < names.size(); k++)
+            library[face->cell_local_id * names.size() + k] = face->parameter(names[k]);
+    }
 }
 
 
@@ -275,8 +298,8 @@ void WindNinja::run(mesh& domain)
         {
             auto face = domain->face(i);
 
-            std::vector<boost::tuple<double, double, double> > u;
-            std::vector<boost::tuple<double, double, double> > v;
+            static thread_local interp_samples samples; // zonal u and v, interpolated together
+            samples.clear();
             for (auto &s : face->stations())
             {
                 if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
@@ -295,8 +318,9 @@ void WindNinja::run(mesh& domain)
                 double zonal_u = -W * sin(theta);
                 double zonal_v = -W * cos(theta);
 
-                u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
-                v.push_back(boost::make_tuple(s->x(), s->y(), zonal_v));
+                samples.push_back(s->x(), s->y());
+                samples.values.push_back(zonal_u);
+                samples.values.push_back(zonal_v);
             }
 
             /**
@@ -310,8 +334,10 @@ void WindNinja::run(mesh& domain)
 
             // get an interpolated zonal U,V at our face
             auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-            double zonal_u = face->get_module_data<data>(ID)->interp(u, query);
-            double zonal_v = face->get_module_data<data>(ID)->interp(v, query);
+            double interpolated[2];
+            face->get_module_data<data>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+            double zonal_u = interpolated[0];
+            double zonal_v = interpolated[1];
 
             (*face)["interp_zonal_u"_s]= zonal_u;
             (*face)["interp_zonal_v"_s]= zonal_v;
@@ -341,15 +367,10 @@ void WindNinja::run(mesh& domain)
                 (*face)["lookup_d"_s]= d;
 
                 // get the transfert function and associated wind component for the interpolated wind direction
-		if(L_avg == -1)
-                {
-			W_transf = face->parameter("Ninja" + std::to_string(d));   // transfert function
-		}else
-		{
-			W_transf = face->parameter("Ninja" + std::to_string(d) +'_' + std::to_string(L_avg));   // transfert function
-                }
-                U = face->parameter("Ninja" + std::to_string(d) + "_U");  // zonal component
-                V = face->parameter("Ninja" + std::to_string(d) + "_V");  // meridional component
+                const double* field = windfield(face->cell_local_id, d);
+                W_transf = field[0];   // transfert function
+                U = field[1];  // zonal component
+                V = field[2];  // meridional component
 
            }else // Linear interpolation between the closest 2 wind fields from the library
            {
@@ -367,34 +388,20 @@ void WindNinja::run(mesh& domain)
                 double d = d1*(theta2-theta)/(theta2-theta1)+d2*(theta-theta1)/(theta2-theta1);
                 (*face)["lookup_d"_s]= d;
 
-		double W_transf1 = 0.;
+                // zonal2dir adds 2pi to tiny negative angles, which can round to exactly 2pi. The next field is then
+                // past the last library direction, wrap it around to the first
+                if (d2 > N_windfield) d2 -= N_windfield;
+
                 // get the transfert function and associated wind component for the interpolated wind direction
-		if(L_avg == -1)
-		{
-                	W_transf1 = face->parameter("Ninja" + std::to_string(d1));   // transfert function
-                }else
-		{
-			W_transf1 = face->parameter("Ninja" + std::to_string(d1)+'_' + std::to_string(L_avg));   // transfert function
-		}
-
-                double U_lib1 = face->parameter("Ninja" + std::to_string(d1) + "_U");  // zonal component
-                double V_lib1 = face->parameter("Ninja" + std::to_string(d1) + "_V");  // meridional component
-
-		double W_transf2 = 0.;
-		if(L_avg == -1)
-		{
-                	W_transf2 = face->parameter("Ninja" + std::to_string(d2));   // transfert function
-                }else
-		{
-			W_transf2 = face->parameter("Ninja" + std::to_string(d2)+'_' + std::to_string(L_avg));   // transfert function
-                }
-		double U_lib2 = face->parameter("Ninja" + std::to_string(d2) + "_U");  // zonal component
-                double V_lib2 = face->parameter("Ninja" + std::to_string(d2) + "_V");  // meridional component
+                const double* field1 = windfield(face->cell_local_id, d1);
+                const double* field2 = windfield(face->cell_local_id, d2);
 
                 // Determine wind component from the wind field library using a weighted mean
-                U = U_lib1*(theta2-theta)/(theta2-theta1)+U_lib2*(theta-theta1)/(theta2-theta1);
-                V = V_lib1*(theta2-theta)/(theta2-theta1)+V_lib2*(theta-theta1)/(theta2-theta1);
-                W_transf = W_transf1*(theta2-theta)/(theta2-theta1)+W_transf2*(theta-theta1)/(theta2-theta1);
+                double w1 = (theta2-theta)/(theta2-theta1);
+                double w2 = (theta-theta1)/(theta2-theta1);
+                W_transf = field1[0]*w1 + field2[0]*w2;
+                U = field1[1]*w1 + field2[1]*w2;
+                V = field1[2]*w1 + field2[2]*w2;
             }
 
             if(fabs(W_transf)> transf_max )
@@ -481,18 +488,19 @@ void WindNinja::run(mesh& domain)
         {
 
             auto face = domain->face(i);
-            std::vector<boost::tuple<double, double, double> > u;
+            static thread_local interp_samples u;
+            u.clear();
             for (size_t j = 0; j < 3; j++)
             {
                 auto neigh = face->neighbor(j);
                 if (neigh != nullptr)
-                    u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(),(*neigh)["U_R"_s]));
+                    u.push_back(neigh->get_x(), neigh->get_y(), (*neigh)["U_R"_s]);
             }
 
             auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
             if(u.size() > 0)
             {
-                double new_u = face->get_module_data<data>(ID)->interp_smoothing(u, query);
+                double new_u = face->get_module_data<data>(ID)->interp_smoothing(u.view(), query);
                 face->get_module_data<data>(ID)->temp_u = new_u;
             }
             else
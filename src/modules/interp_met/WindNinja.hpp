@@ -28,6 +28,7 @@
 #include "module_base.hpp"
 #include "math/coordinates.hpp"
 #include <physics/Atmosphere.h>
+#include <cassert>
 #include <cstdlib>
 #include <string>
 
@@ -191,4 +192,15 @@ public:
     bool compute_Sx; // uses the Sx module to influence the windspeeds so Sx needs to be computed during the windspeed evaluation, instead of a seperate module
     double Sx_crit;    // Critical values of the Winstral parameter to determine the occurence of flow separation.
     boost::shared_ptr<Winstral_parameters> Sx;
+
+    // The wind field library, loaded from the parameters at init so the timestep doesn't look up parameters by name.
+    // Laid out [face][direction][component] by cell_local_id, for the library directions 1..N_windfield, with components
+    // 0 = transfer function, 1 = U, 2 = V
+    std::vector<double> library;
+
+    inline const double* windfield(size_t row, int d) const
+    {
+        assert(d >= 1 && d <= N_windfield);
+        return &library[(row * N_windfield + (d - 1)) * 3];
+    }
 };
@@ -60,22 +60,25 @@ void iswr_from_nwp::run(mesh_elem &face)
     //interpolate all the measured qsi and qsi_diff from the NWP model
 
     //lower all the station values to sea level prior to the interpolation
-    std::vector< boost::tuple<double, double, double> > lowered_values;
-    std::vector< boost::tuple<double, double, double> > lowered_values2;
+    static thread_local interp_samples samples; // Qsi and Qsi_diff, interpolated together
+    samples.clear();
     for (auto& s : face->stations())
     {
         if( (is_nan((*s)["Qsi"_s])) || (is_nan((*s)["Qsi_diff"_s])))
             continue;
         double v = (*s)["Qsi"_s];
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
+        samples.push_back(s->x(), s->y());
+        samples.values.push_back(v);
         double vv = (*s)["Qsi_diff"_s];
-        lowered_values2.push_back( boost::make_tuple(s->x(), s->y(), vv ) );
+        samples.values.push_back(vv);
     }
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
     // Read interpolated total and diffuse iswr
-    double iswr_observed =face->get_module_data<data>(ID)->interp(lowered_values, query);
-    double split_diff =face->get_module_data<data>(ID)->interp(lowered_values2, query);
+    double interpolated[2];
+    face->get_module_data<data>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+    double iswr_observed = interpolated[0];
+    double split_diff = interpolated[1];
 
     // Compute direct part
     double split_dir = iswr_observed - split_diff;
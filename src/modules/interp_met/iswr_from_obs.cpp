@@ -61,18 +61,19 @@ void iswr_from_obs::run(mesh_elem &face)
     //interpolate all the measured qsi
 
     //lower all the station values to sea level prior to the interpolation
-    std::vector< boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["Qsi"_s]))
             continue;
         double v = (*s)["Qsi"_s];
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), v ) );
+        lowered_values.push_back(s->x(), s->y(), v);
     }
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double iswr_observed =face->get_module_data<data>(ID)->interp(lowered_values, query);
+    double iswr_observed =face->get_module_data<data>(ID)->interp(lowered_values.view(), query);
 
 
     // This is what is used in SUMMA
@@ -71,7 +71,8 @@ void kunkel_rh::run(mesh_elem &face)
             };
 
     double lapse = lapse_rates[global_param->month() - 1] / 1000.0; // -> 1/m
-    std::vector<boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto &s : face->stations())
     {
         if( is_nan((*s)["rh"_s]))
@@ -80,12 +81,12 @@ void kunkel_rh::run(mesh_elem &face)
 
         double rh_z = rh * exp(lapse * (0.0 - s->z()));
 
-        lowered_values.push_back(boost::make_tuple(s->x(), s->y(), rh_z));
+        lowered_values.push_back(s->x(), s->y(), rh_z);
     }
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double value = face->get_module_data<data>(ID)->interp(lowered_values, query);//C
+    double value = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);//C
 
     double rh = value * exp(lapse * (face->get_z() - 0.0));
 
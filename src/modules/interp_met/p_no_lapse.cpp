@@ -52,19 +52,18 @@ void p_no_lapse::init(mesh& domain)
 void p_no_lapse::run(mesh_elem& face)
 {
 
-    std::vector< boost::tuple<double, double, double> > ppt;
-    std::vector< boost::tuple<double, double, double> > staion_z;
+    static thread_local interp_samples ppt;
+    ppt.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["p"_s]))
             continue;
         double u = (*s)["p"_s];
-        ppt.push_back( boost::make_tuple(s->x(), s->y(), u ) );
-        staion_z.push_back( boost::make_tuple(s->x(), s->y(), s->z() ) );
+        ppt.push_back(s->x(), s->y(), u);
     }
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double p0 = face->get_module_data<data>(ID)->interp(ppt, query);
+    double p0 = face->get_module_data<data>(ID)->interp(ppt.view(), query);
 
     double P_fin = -9999;
 
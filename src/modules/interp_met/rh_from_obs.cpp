@@ -86,7 +86,8 @@ void rh_from_obs::run(mesh_elem& face)
         last_update = global_param->posix_time();
     }
 
-    std::vector< boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto& s : face->stations())
     {
         if( is_nan((*s)["t"_s]) || is_nan((*s)["rh"_s]))
@@ -98,13 +99,13 @@ void rh_from_obs::run(mesh_elem& face)
         double ea = rh * es;
         double z = s->z();
         ea = ea + lapse*(0.0-z);
-        lowered_values.push_back( boost::make_tuple(s->x(), s->y(), ea ) );
+        lowered_values.push_back(s->x(), s->y(), ea);
 
     }
 
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double ea = face->get_module_data<data>(ID)->interp(lowered_values, query);
+    double ea = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);
 
     //raise it back up
     ea = ea + lapse*( face->get_z() - 0.0);
@@ -53,18 +53,19 @@ void rh_no_lapse::init(mesh& domain)
 void rh_no_lapse::run(mesh_elem &face)
 {
 
-    std::vector<boost::tuple<double, double, double> > lowered_values;
+    static thread_local interp_samples lowered_values;
+    lowered_values.clear();
     for (auto &s : face->stations())
     {
         if( is_nan((*s)["rh"_s]))
             continue;
         double rh = (*s)["rh"_s];
 
-        lowered_values.push_back(boost::make_tuple(s->x(), s->y(), rh));
+        lowered_values.push_back(s->x(), s->y(), rh);
     }
 
     auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-    double rh = face->get_module_data<data>(ID)->interp(lowered_values, query);
+    double rh = face->get_module_data<data>(ID)->interp(lowered_values.view(), query);
 
     rh = std::min(rh, 100.0);
     rh = std::max(10.0, rh);
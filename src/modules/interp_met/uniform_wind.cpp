@@ -67,8 +67,8 @@ void uniform_wind::run(mesh& domain)
 
         auto face = domain->face(i);
 
-        std::vector<boost::tuple<double, double, double> > u;
-        std::vector<boost::tuple<double, double, double> > v;
+        static thread_local interp_samples samples; // zonal u and v, interpolated together
+        samples.clear();
         for (auto &s : face->stations())
         {
            if (is_nan((*s)["U_R"_s]) || is_nan((*s)["vw_dir"_s]))
@@ -80,14 +80,17 @@ void uniform_wind::run(mesh& domain)
            double theta = (*s)["vw_dir"_s] * M_PI / 180.;
            double zonal_u = -W * sin(theta);
            double zonal_v = -W * cos(theta);
-           u.push_back(boost::make_tuple(s->x(), s->y(), zonal_u));
-           v.push_back(boost::make_tuple(s->x(), s->y(), zonal_v));
+           samples.push_back(s->x(), s->y());
+           samples.values.push_back(zonal_u);
+           samples.values.push_back(zonal_v);
         }
 
         // Interp over stations
         auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
-        double zonal_u = face->get_module_data<lwinddata>(ID)->interp(u, query);
-        double zonal_v = face->get_module_data<lwinddata>(ID)->interp(v, query);
+        double interpolated[2];
+        face->get_module_data<lwinddata>(ID)->interp(samples.view(), samples.values.data(), 2, query, interpolated);
+        double zonal_u = interpolated[0];
+        double zonal_v = interpolated[1];
 
         // Convert back to direction and magnitude
         double theta = 3.0 * M_PI * 0.5 - atan2(zonal_v, zonal_u);
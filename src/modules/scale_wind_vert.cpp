@@ -188,20 +188,21 @@ void scale_wind_vert::run(mesh& domain)
     {
         auto face = domain->face(i);
 
-        std::vector<boost::tuple<double, double, double> > u;
+        static thread_local interp_samples u;
+        u.clear();
         for (size_t j = 0; j < 3; j++)
         {
          auto neigh = face->neighbor(j);
 
          if (neigh != nullptr)
-           u.push_back(boost::make_tuple(neigh->get_x(), neigh->get_y(), (*neigh)["U_2m_above_srf"_s]));
+           u.push_back(neigh->get_x(), neigh->get_y(), (*neigh)["U_2m_above_srf"_s]);
         }
 
         auto query = boost::make_tuple(face->get_x(), face->get_y(), face->get_z());
 
         if(u.size()>0)
         {
-         double new_u =  face->get_module_data<d>(ID)->interp(u, query);
+         double new_u =  face->get_module_data<d>(ID)->interp(u.view(), query);
          face->get_module_data<d>(ID)->temp_u = std::max(0.1,new_u);
         }
         else
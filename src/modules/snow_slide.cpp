@@ -75,22 +75,25 @@ void snow_slide::run(mesh& domain)
     // Make a vector of pairs (elevation + snowdepth, pointer to face)
     tbb::concurrent_vector< std::pair<double, mesh_elem> > sorted_z(domain->size_faces());
 
+    auto& geo = domain->geometry();
+
 #pragma omp parallel for
     for(size_t i = 0; i  < domain->size_faces(); i++)
     {
 
         auto face = domain->face(i); // Get face
+        size_t row = face->cell_local_id;
         // Make copy of snowdepthavg and swe to modify within snow_slide (not saved)
         // snowdepthavg_vert is taken vertically
         auto data = face->get_module_data<snow_slide::data>(ID); // Get data
         data->snowdepthavg_copy = (*face)["snowdepthavg"_s]; // Store copy of snowdepth for snow_slide use
-        data->snowdepthavg_vert_copy = (*face)["snowdepthavg"_s]/std::max(0.001,cos(face->slope())); // Vertical snow depth
+        data->snowdepthavg_vert_copy = (*face)["snowdepthavg"_s]/std::max(0.001,cos(geo.slope[row])); // Vertical snow depth
         data->swe_copy = (*face)["swe"_s]/1000; // mm to m
-        data->slope = face->slope(); // slope in rad
+        data->slope = geo.slope[row]; // slope in rad
         // Initalize snow transport to zero
         data->delta_avalanche_snowdepth = 0.0;
         data->delta_avalanche_mass = 0.0; // m
-        sorted_z.at(i) = std::make_pair( face->center().z() + (*face)["snowdepthavg"_s]/std::max(0.001,cos(face->slope())), face) ;
+        sorted_z.at(i) = std::make_pair( geo.z[row] + data->snowdepthavg_vert_copy, face) ;
 
     }
 
@@ -105,7 +108,8 @@ void snow_slide::run(mesh& domain)
     // Loop through each face, from highest to lowest triangle surface
     for (size_t i = 0; i < sorted_z.size(); i++) {
         auto face = sorted_z[i].second; // Get pointer to face
-        double cen_area = face->get_area(); // Area of center triangle
+        size_t row = face->cell_local_id;
+        double cen_area = geo.area[row]; // Area of center triangle
         auto data = face->get_module_data<snow_slide::data>(ID); // Get stored data for face
 
         // Get current triangle snow info at beginning of time step
@@ -129,7 +133,7 @@ void snow_slide::run(mesh& domain)
             double del_swe   = swe * (1 - maxDepth / snowdepthavg); // Amount of swe to be removed (positive) [m]
             double orig_mass = del_swe * cen_area;
 
-            double z_s = face->center().z() + snowdepthavg_vert; // Current face elevation + vertical snowdepth
+            double z_s = geo.z[row] + snowdepthavg_vert; // Current face elevation + vertical snowdepth
             std::vector<double> w = {0, 0, 0}; // Weights for each face neighbor to route snow to
             double w_dem = 0; // Denomenator for weights (sum of all elev diffs)
             bool edge_flag = false; // Flag for determiing if current cell is an edge (handel routing differently)
@@ -147,7 +151,7 @@ void snow_slide::run(mesh& domain)
                     auto n_data = n->get_module_data<snow_slide::data>(ID); // pointer to face's data
                     // Calc weighting based on height diff
                     // (std::max insures that if one neighbor is higher, its weight will be zero)
-                    w[i] = std::max(0.0, z_s - (n->center().z() + n_data->snowdepthavg_vert_copy));
+                    w[i] = std::max(0.0, z_s - (geo.z[n->cell_local_id] + n_data->snowdepthavg_vert_copy));
                     w_dem += w[i]; // Store weight denominator
                 } else { // It is an edge cell, set flag
                     edge_flag = true;
@@ -188,7 +192,7 @@ void snow_slide::run(mesh& domain)
             for (int j = 0; j < 3; ++j) {
                 auto n = face->neighbor(j);
                 if (n != nullptr && !n->is_ghost)  {
-                    double n_area = n->get_area(); // Area of neighbor triangle
+                    double n_area = geo.area[n->cell_local_id]; // Area of neighbor triangle
                     auto   n_data = n->get_module_data<snow_slide::data>(ID); // pointer to face's data
 
                     // // Update neighbor snowdepth and swe (copies only for internal snowSlide use)
@@ -200,7 +204,7 @@ void snow_slide::run(mesh& domain)
                     n_data->snowdepthavg_copy += del_depth * (cen_area/n_area) * w[j]; // (m)
                     n_data->swe_copy += del_swe * (cen_area/n_area) * w[j]; // (m)
                     // Update vertical snow depth
-                    n_data->snowdepthavg_vert_copy = n_data->snowdepthavg_copy/std::max(0.001,cos(face->slope()));
+                    n_data->snowdepthavg_vert_copy = n_data->snowdepthavg_copy/std::max(0.001,cos(geo.slope[row]));
 
                     // Update mass transport to neighbor
                     n_data->delta_avalanche_snowdepth += del_depth * cen_area * w[j]; // Fraction of snowdepth (m) *
@@ -211,7 +215,7 @@ void snow_slide::run(mesh& domain)
             }
             // Remove snow from initial face
             data->snowdepthavg_copy = maxDepth; // data refers to current/center cell
-            data->snowdepthavg_vert_copy =  data->snowdepthavg_copy/std::max(0.001,cos(face->slope()));
+            data->snowdepthavg_vert_copy =  data->snowdepthavg_copy/std::max(0.001,cos(geo.slope[row]));
             data->swe_copy = swe * maxDepth / snowdepthavg; // Uses ratio of depth change to calc new swe
             // This relys on the assumption of uniform density.
 
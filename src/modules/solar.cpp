@@ -25,7 +25,7 @@
 REGISTER_MODULE_CPP(solar);
 
 solar::solar(config_file cfg)
-        : module_base("solar", parallel::data, cfg)
+        : module_base("solar", parallel::domain, cfg)
 {
     provides("solar_el");
     provides("solar_az");
@@ -36,35 +36,19 @@ solar::~solar()
 {
 
 }
-void solar::run(mesh_elem &face)
-{
-    double Lon = 0;
-    double Lat = 0;
-    if(global_param->is_geographic())
-    {
-        Lon = face->center().x();
-        Lat = face->center().y();
-    }
-    else{
-        auto data = face->get_module_data<solar::data>(ID);
-        Lon = data->lng;
-        Lat = data->lat;
-    }
-
 
+solar::ephemeris solar::compute_ephemeris(const boost::posix_time::ptime& t)
+{
     //Following the RA DEC to Az Alt conversion sequence explained here:
     //http://www.stargazing.net/kepler/altaz.html
 
-    //UTC offset. Don't know how to use datetime's UTC converter yet....
-    boost::posix_time::time_duration UTC_offset = boost::posix_time::hours(global_param->_utc_offset);
-    std::tm tm = boost::posix_time::to_tm(global_param->posix_time()+UTC_offset);
+    std::tm tm = boost::posix_time::to_tm(t);
     double year =  tm.tm_year + 1900.; //convert from epoch
     double month =  tm.tm_mon + 1.;//conert jan == 0
     double day =   tm.tm_mday; //starts at 1, ok
     double hour = tm.tm_hour; // 0 = midnight, ok
     double min = tm.tm_min; // 0, ok
     double sec = tm.tm_sec; // [0,60] in c++11, ok http://en.cppreference.com/w/cpp/chrono/c/tm
-    double Alt = face->center().z();//0.; //TODO: fix this?
 
     if (month <= 2.0)
     {
@@ -79,7 +63,6 @@ void solar::run(mesh_elem &face)
     double d = jd-2451543.5;
     // Keplerian Elements for the Sun (geocentric)
     double w = 282.9404+4.70935*pow(10,-5)*d; //    (longitude of perihelion degrees)
-    double a = 1.000000;          //    (mean distance, a.u.)
     double e = 0.016709- 1.151*pow(10.,-9.)*d;  //    (eccentricity)
     double M = fmod(356.0470+0.9856002585*d,360.0); //  (mean anomaly degrees)
     double L = w + M;                     //(Sun's mean longitude degrees)
@@ -97,7 +80,6 @@ void solar::run(mesh_elem &face)
     double r = sqrt(x*x + y*y);
     double v = atan2(y,x)*(180./M_PI);
 
-
     //find the longitude of the sun
     double lon = v + w;
 
@@ -111,59 +93,86 @@ void solar::run(mesh_elem &face)
     double yequat = yeclip*cos(oblecl*(M_PI/180.))+zeclip*sin(oblecl*(M_PI/180.));
     double zequat = yeclip*sin(23.4406*(M_PI/180.))+zeclip*cos(oblecl*(M_PI/180.));
 
-    //convert equatorial rectangular coordinates to RA and Decl:
-    r = sqrt(xequat*xequat + yequat*yequat + zequat*zequat)-(Alt/149598000.0); //roll up the altitude correction
-    double RA = atan2(yequat,xequat)*(180./M_PI);
-    double delta = asin(zequat/r)*(180./M_PI);
-
-    //Find the J2000 value
-    double J2000 = jd - 2451545.0;
+    ephemeris eph;
+    eph.r = sqrt(xequat*xequat + yequat*yequat + zequat*zequat);
+    eph.zequat = zequat;
+    eph.RA = atan2(yequat,xequat)*(180./M_PI);
 
     double UTH = hour+min/60.0+sec/3600.0;   //Calculate local siderial time
     double GMST0=fmod(L+180.,360.)/15.;
-    double SIDTIME = GMST0 + UTH + Lon/15.;
 
-    //Replace RA with hour angle HA
-    double HA = (SIDTIME*15. - RA);
+    // hour angle at Greenwich, the local one adds the longitude
+    eph.H0 = (GMST0 + UTH)*15. - eph.RA;
 
-    //convert to rectangular coordinate system
-    x = cos(HA*(M_PI/180.))*cos(delta*(M_PI/180.));
-    y = sin(HA*(M_PI/180.))*cos(delta*(M_PI/180.));
-    double z = sin(delta*(M_PI/180.));
+    return eph;
+}
 
-    //rotate this along an axis going east-west.
-    double xhor = x*cos((90.-Lat)*(M_PI/180.))-z*sin((90.-Lat)*(M_PI/180.));
-    double yhor = y;
-    double zhor = x*sin((90.-Lat)*(M_PI/180.))+z*cos((90.-Lat)*(M_PI/180.));
+void solar::run(mesh& domain)
+{
+    //UTC offset. Don't know how to use datetime's UTC converter yet....
+    boost::posix_time::time_duration UTC_offset = boost::posix_time::hours(global_param->_utc_offset);
+    ephemeris eph = compute_ephemeris(global_param->posix_time()+UTC_offset);
 
-    //Find the h and AZ
-    double Az = atan2(yhor,xhor)*(180./M_PI) + 180.;
-    double El = asin(zhor)*(180./M_PI);
+    double cos_H0 = cos(eph.H0*(M_PI/180.));
+    double sin_H0 = sin(eph.H0*(M_PI/180.));
 
-    (*face)["solar_az"_s]=Az;
-    (*face)["solar_el"_s]=El;
+    auto& store = domain->variable_store();
+    double* solar_az = store.column(domain->resolve_variable("solar_az"_s));
+    double* solar_el = store.column(domain->resolve_variable("solar_el"_s));
+
+    const double* sin_lat = _sin_lat.data();
+    const double* cos_lat = _cos_lat.data();
+    const double* sin_lon = _sin_lon.data();
+    const double* cos_lon = _cos_lon.data();
+    const double* alt = _alt.data();
+
+    size_t n = domain->size_faces();
+
+#pragma omp parallel for simd
+    for (size_t i = 0; i < n; i++)
+    {
+        //roll up the altitude correction
+        double r = eph.r - (alt[i]/149598000.0);
+        double sin_delta = eph.zequat / r;
+        double cos_delta = sqrt(1. - sin_delta*sin_delta);
+
+        //hour angle HA = H0 + Lon, expanded so only the cached trig of Lon is needed
+        double cos_HA = cos_H0*cos_lon[i] - sin_H0*sin_lon[i];
+        double sin_HA = sin_H0*cos_lon[i] + cos_H0*sin_lon[i];
+
+        //convert to rectangular coordinate system
+        double x = cos_HA*cos_delta;
+        double y = sin_HA*cos_delta;
+        double z = sin_delta;
+
+        //rotate this along an axis going east-west, by 90-Lat
+        double xhor = x*sin_lat[i] - z*cos_lat[i];
+        double yhor = y;
+        double zhor = x*cos_lat[i] + z*sin_lat[i];
+
+        //Find the h and AZ
+        solar_az[i] = atan2(yhor,xhor)*(180./M_PI) + 180.;
+        solar_el[i] = asin(zhor)*(180./M_PI);
+    }
 
 }
 void solar::init(mesh& domain)
 {
 
-    //number of steps along the search vector to check for a higher point
-    int steps = cfg.get("svf.steps",10);
     //max distance to search
     double max_distance = cfg.get("svf.max_distance",1000.0);
 
-    //size of the step to take
-    double size_of_step = max_distance / steps;
-
     //number of azimuthal sections
     int N = cfg.get("svf.nsectors", 12);
 
 
-    double azimuthal_width = 360./(double)N; // in degrees
-
-
     bool svf_compute = cfg.get("svf.compute",true);
 
+    // the horizons in each sector, shared with fast_shadow if it uses the same sectors and distance
+    std::shared_ptr<const horizon_map> horizon;
+    if(svf_compute)
+        horizon = domain->horizon(N, max_distance);
+
     OGRSpatialReference monUtm;
     OGRSpatialReference monGeo;
     OGRCoordinateTransformation* coordTrans = nullptr;
@@ -178,61 +187,39 @@ void solar::init(mesh& domain)
         coordTrans = OGRCreateCoordinateTransformation(&monUtm, &monGeo);
     }
 
+    size_t n = domain->size_faces();
+    _sin_lat.resize(n);
+    _cos_lat.resize(n);
+    _sin_lon.resize(n);
+    _cos_lon.resize(n);
+    _alt.resize(n);
+
     #pragma omp parallel for
     for (size_t i = 0; i < domain->size_faces(); i++)
     {
 
 	       auto face = domain->face(i);
 
+	       double lng = face->center().x();
+	       double lat = face->center().y();
+
 	       // we are UTM and need to convert internally to lat long to calc the solar position
 	       if(!domain->is_geographic())
 	       {
-		   double x = face->center().x();
-		   double y = face->center().y();
-		   int reprojected = coordTrans->Transform(1, &x, &y);
-
-		   auto d = face->make_module_data<solar::data>(ID);
-		   d->lat = y;
-		   d->lng = x;
+		   coordTrans->Transform(1, &lng, &lat);
 	       }
 
+	       _sin_lat[i] = sin(lat*(M_PI/180.));
+	       _cos_lat[i] = cos(lat*(M_PI/180.));
+	       _sin_lon[i] = sin(lng*(M_PI/180.));
+	       _cos_lon[i] = cos(lng*(M_PI/180.));
+	       _alt[i] = face->center().z();
+
 	       double svf = 0.0;
 
-	       if(svf_compute)
+	       if(horizon)
 	       {
-               Point_3 me = face->center();
-               auto cosSlope = cos(face->slope());
-               auto sinSlope = sin(face->slope());
-
-               //for each search azimuthal sector
-               for (int k = 0; k < N; k++)
-               {
-                   double phi = 0.;
-                   // search along each azimuth in j step increments to find horizon angle
-                   for (int j = 1; j <= steps; ++j)
-                   {
-                   double distance = j * size_of_step;
-
-                   auto f = domain->find_closest_face(math::gis::point_from_bearing(me, k * azimuthal_width, distance));
-
-                   double z_diff = (f->center().z() - me.z());
-                   if (z_diff > 0)
-                   {
-                       double dist = math::gis::distance(f->center(), me);
-                       phi = std::max(atan(z_diff / dist), phi);
-                   }
-                   }
-
-                   auto cosPhi = cos(phi);
-                   auto sinPhi = sin(phi);
-                   auto azi_in_rad = (k * azimuthal_width * M_PI / 180.);
-
-                   svf += cosSlope * cosPhi * cosPhi +
-                 sinSlope * cos(azi_in_rad - face->aspect()) * (M_PI_2 - phi - sinPhi * cosPhi);
-
-               }
-
-               svf /= (double)N;
+               svf = horizon->svf(face->cell_local_id, face->slope(), face->aspect());
 	       } else{
 		        svf = 1.;
 	       }
@@ -25,6 +25,7 @@
 
 #include "module_base.hpp"
 #include <ogr_spatialref.h>
+#include <vector>
 
 
 /**
@@ -51,20 +52,12 @@
  *    {
  *       "svf":
  *       {
- *          "steps": 10.
  *          "max_distance": 1000.0,
  *          "nsectors": 12,
  *          "compute": true
  *       }
  *    }
  *
- * .. confval:: steps
- *
- *    :type: int
- *    :default: 10
- *
- *    Number of search steps
- *
  * .. confval:: max_distance
  *
  *    :default: 1000.0
@@ -95,15 +88,30 @@ class solar : public module_base
 REGISTER_MODULE_HPP(solar);
 public:
 
-    //if we have a UTM mesh, cache the calculated lat and long
-    struct data : public face_info
+    /// Solar position terms that depend only on the time, computed once per timestep
+    struct ephemeris
     {
-        double lat;
-        double lng;
+        double RA;       // right ascension [degrees]
+        double r;        // geocentric distance [au]
+        double zequat;   // equatorial z coordinate [au]
+        double H0;       // hour angle at longitude 0, Greenwich sidereal time - RA [degrees]
     };
 
+    /// Computes the ephemeris for a time, which should already be offset to UTC
+    /// @param t
+    /// @return
+    static ephemeris compute_ephemeris(const boost::posix_time::ptime& t);
+
     solar(config_file cfg);
     ~solar();
-    void run(mesh_elem &face);
+    void run(mesh& domain);
     void init(mesh& domain);
+
+private:
+    // per face position, indexed by cell_local_id. Trig is cached as only the hour angle changes with time
+    std::vector<double> _sin_lat;
+    std::vector<double> _cos_lat;
+    std::vector<double> _sin_lon;
+    std::vector<double> _cos_lon;
+    std::vector<double> _alt;
 };
@@ -0,0 +1,171 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "output_writer.hpp"
+#include "utility/profiler.hpp"
+
+output_writer::output_writer()
+{
+    _max_queue = 1;
+    _busy = false;
+    _stop = false;
+    _running = false;
+    _stalls = 0;
+    _stall_time = 0;
+}
+
+output_writer::~output_writer()
+{
+    try
+    {
+        stop();
+    }
+    catch(...)
+    {
+        // can't throw from the destructor and the error has already been reported by the worker
+    }
+}
+
+void output_writer::start(size_t max_queue)
+{
+    if(_running)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Output writer has already been started."));
+
+    if(max_queue == 0)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Output writer queue must hold at least 1 job."));
+
+    _max_queue = max_queue;
+    _stop = false;
+    _running = true;
+    _thread = std::thread(&output_writer::worker, this);
+}
+
+bool output_writer::running()
+{
+    return _running;
+}
+
+void output_writer::submit(std::function<void()> job)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    rethrow();
+
+    if(_queue.size() >= _max_queue)
+    {
+        ++_stalls;
+        int64_t start = profiler::now();
+        _not_full.wait(lock, [this]{ return _queue.size() < _max_queue || _error; });
+        _stall_time += (profiler::now() - start) * 1e-9;
+        rethrow();
+    }
+
+    _queue.push_back(std::move(job));
+    _not_empty.notify_one();
+}
+
+void output_writer::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]{ return (_queue.empty() && !_busy) || _error; });
+    rethrow();
+}
+
+void output_writer::stop()
+{
+    if(!_running)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _not_empty.notify_one();
+    _thread.join();
+    _running = false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    rethrow();
+}
+
+size_t output_writer::stalls()
+{
+    return _stalls;
+}
+
+double output_writer::stall_time()
+{
+    return _stall_time;
+}
+
+void output_writer::rethrow()
+{
+    if(_error)
+    {
+        auto e = _error;
+        _error = nullptr;
+        _queue.clear();
+        std::rethrow_exception(e);
+    }
+}
+
+void output_writer::worker()
+{
+    while(true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _not_empty.wait(lock, [this]{ return !_queue.empty() || _stop; });
+
+            // drain everything that was queued before stopping
+            if(_queue.empty())
+                break;
+
+            job = std::move(_queue.front());
+            _queue.pop_front();
+            _busy = true;
+        }
+        _not_full.notify_one();
+
+        std::exception_ptr failure = nullptr;
+        try
+        {
+            PROFILE_SCOPE("output_writer::job");
+            job();
+        }
+        catch(...)
+        {
+            LOG_ERROR << "Background output write failed";
+            failure = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy = false;
+            if(failure && !_error)
+                _error = failure;
+        }
+        _not_full.notify_one();
+        _idle.notify_all();
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+//std includes
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//CHM includes
+#include "exception.hpp"
+#include "logger.hpp"
+
+/**
+ * Runs output jobs (e.g., writing a vtu file) on a dedicated background thread so the timestep loop does not wait on
+ * the filesystem.
+ *
+ * Jobs must own all the data they need, normally a snapshot of the mesh variables taken on the model thread. The queue
+ * is bounded: submit() blocks while max_queue jobs are pending, which caps the memory held by snapshots and throttles the
+ * model to the speed of the disk if output cannot keep up.
+ *
+ * An exception thrown by a job is held and rethrown on the model thread from the next submit() or flush().
+ */
+class output_writer
+{
+  public:
+    output_writer();
+    ~output_writer();
+
+    /**
+     * Starts the writer thread.
+     * @param max_queue Maximum number of pending jobs. Must be at least 1
+     */
+    void start(size_t max_queue);
+
+    /**
+     * Is the writer thread running
+     * @return
+     */
+    bool running();
+
+    /**
+     * Queues a job, blocking while the queue is full.
+     * @param job
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * Blocks until every queued job has been written.
+     */
+    void flush();
+
+    /**
+     * Flushes and joins the writer thread. Called by the destructor.
+     */
+    void stop();
+
+    /**
+     * Number of submit() calls that had to wait on a full queue
+     * @return
+     */
+    size_t stalls();
+
+    /**
+     * Total time, in seconds, submit() spent waiting on a full queue
+     * @return
+     */
+    double stall_time();
+
+  private:
+    void worker();
+    // rethrows a held job exception. Must hold _mutex
+    void rethrow();
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+    std::condition_variable _idle;
+
+    std::deque< std::function<void()> > _queue;
+    size_t _max_queue;
+    bool _busy; // a job has been popped and is being run
+    bool _stop;
+    bool _running;
+
+    std::exception_ptr _error;
+
+    size_t _stalls;
+    double _stall_time; // s
+};
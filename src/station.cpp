@@ -111,6 +111,16 @@ void station::init(std::set<std::string> variables)
     _timestep_data.init(variables);
 }
 
+std::vector<std::string> station::variables()
+{
+    return _timestep_data.variables();
+}
+
+void station::swap_timestep_data(station& other)
+{
+    _timestep_data.swap(other._timestep_data);
+}
+
 boost::gregorian::date station::get_gregorian()
 {
     boost::gregorian::date date;
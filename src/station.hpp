@@ -168,6 +168,17 @@ public:
     double& operator[](const uint64_t& hash);
     double& operator[](const std::string& variable);
 
+    /**
+     * Returns the variables stored by this station
+     */
+    std::vector<std::string> variables();
+
+    /**
+     * Exchanges this timestep's values (and variables) with another station. O(1), used to swap in prefetched forcing.
+     * @param other
+     */
+    void swap_timestep_data(station& other);
+
     /// Stations are equal if they have the same id
     /// @param s
     /// @return
@@ -0,0 +1,244 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "task_graph.hpp"
+
+task_graph::task_graph()
+{
+    _failed = false;
+}
+
+task_graph::~task_graph()
+{
+
+}
+
+size_t task_graph::size()
+{
+    return _nodes.size();
+}
+
+void task_graph::build(const std::vector<module>& modules,
+                       const std::vector<std::pair<std::string, std::string>>& edges,
+                       mesh& domain,
+                       size_t block_size,
+                       bool trace_blocks)
+{
+    if(block_size == 0)
+        BOOST_THROW_EXCEPTION(config_error() << errstr_info("Task graph block size must be > 0"));
+
+    _nodes.clear();
+    _roots.clear();
+
+    size_t nfaces = domain->size_faces();
+    size_t nblocks = nfaces / block_size + (nfaces % block_size == 0 ? 0 : 1);
+
+    // first node index of each module. Data modules occupy nblocks consecutive nodes
+    std::map<std::string, size_t> first_node;
+    std::map<std::string, bool> is_domain;
+
+    for(auto& m : modules)
+    {
+        first_node[m->ID] = _nodes.size();
+        is_domain[m->ID] = m->parallel_type() == module_base::parallel::domain;
+
+        if(m->parallel_type() == module_base::parallel::domain)
+        {
+            node n;
+            n.m = m;
+            n.is_domain = true;
+            n.begin = n.end = 0;
+            n.n_predecessors = 0;
+            n.region = profiler::get().region("module:" + m->ID);
+            n.trace = true;
+            _nodes.push_back(n);
+        }
+        else
+        {
+            for(size_t b = 0; b < nblocks; ++b)
+            {
+                node n;
+                n.m = m;
+                n.is_domain = false;
+                n.begin = b * block_size;
+                n.end = std::min(nfaces, (b + 1) * block_size);
+                n.n_predecessors = 0;
+                n.region = profiler::get().region("module:" + m->ID);
+                n.trace = trace_blocks;
+                _nodes.push_back(n);
+            }
+        }
+    }
+
+    auto add_edge = [&](size_t from, size_t to)
+    {
+        _nodes[from].successors.push_back(to);
+        _nodes[to].n_predecessors++;
+    };
+
+    // edges may be duplicated if a module depends on more than one variable from another module
+    std::set<std::pair<std::string, std::string>> unique_edges(edges.begin(), edges.end());
+
+    for(auto& e : unique_edges)
+    {
+        auto from_itr = first_node.find(e.first);
+        auto to_itr = first_node.find(e.second);
+        if(from_itr == first_node.end() || to_itr == first_node.end())
+            BOOST_THROW_EXCEPTION(module_error() << errstr_info("Task graph edge " + e.first + " -> " + e.second + " refers to an unknown module"));
+
+        size_t from = from_itr->second;
+        size_t to = to_itr->second;
+
+        bool from_domain = is_domain[e.first];
+        bool to_domain = is_domain[e.second];
+
+        if(from_domain && to_domain)
+        {
+            add_edge(from, to);
+        }
+        else if(from_domain)
+        {
+            for(size_t b = 0; b < nblocks; ++b)
+                add_edge(from, to + b);
+        }
+        else if(to_domain)
+        {
+            for(size_t b = 0; b < nblocks; ++b)
+                add_edge(from + b, to);
+        }
+        else
+        {
+            for(size_t b = 0; b < nblocks; ++b)
+                add_edge(from + b, to + b);
+        }
+    }
+
+    for(size_t i = 0; i < _nodes.size(); ++i)
+    {
+        if(_nodes[i].n_predecessors == 0)
+            _roots.push_back(i);
+    }
+
+    _remaining.reset(new std::atomic<int>[_nodes.size()]);
+
+    // the face geometry is lazily computed on first use. Different modules may now touch the same face concurrently,
+    // so ensure it's all been computed before any tasks run
+    #pragma omp parallel for
+    for(size_t i = 0; i < nfaces; ++i)
+    {
+        auto face = domain->face(i);
+        face->center();
+        face->normal();
+        face->slope();
+        face->aspect();
+        face->get_area();
+    }
+
+    LOG_DEBUG << "Task graph: " << _nodes.size() << " nodes, " << _roots.size() << " roots, " << nblocks << " blocks of " << block_size << " faces";
+}
+
+void task_graph::run(mesh& domain)
+{
+    for(size_t i = 0; i < _nodes.size(); ++i)
+    {
+        _remaining[i] = _nodes[i].n_predecessors;
+    }
+
+    _domain = domain;
+    _failed = false;
+    _exception.reset(new ompException);
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for(auto r : _roots)
+            {
+                #pragma omp task firstprivate(r)
+                execute(r);
+            }
+        }
+    } // implicit barrier: all tasks, including those spawned by other tasks, are complete
+
+    _exception->Rethrow();
+}
+
+void task_graph::execute(size_t n)
+{
+    while(true)
+    {
+        auto& nd = _nodes[n];
+
+        if(!_failed)
+        {
+            _exception->Run([&]
+                           {
+                               try
+                               {
+                                   profile_scope p(nd.region, nd.trace);
+                                   if (nd.is_domain)
+                                   {
+                                       nd.m->run(_domain);
+                                   } else
+                                   {
+                                       for (size_t i = nd.begin; i < nd.end; ++i)
+                                       {
+                                           auto face = _domain->face(i);
+                                           nd.m->run(face);
+                                       }
+                                   }
+                               }
+                               catch(...)
+                               {
+                                   _failed = true;
+                                   throw;
+                               }
+                           });
+        }
+
+        // release successors
+        bool have_next = false;
+        size_t next = 0;
+        for(auto s : nd.successors)
+        {
+            if(--_remaining[s] == 0)
+            {
+                if(!have_next)
+                {
+                    have_next = true;
+                    next = s;
+                }
+                else
+                {
+                    #pragma omp task firstprivate(s)
+                    execute(s);
+                }
+            }
+        }
+
+        if(!have_next)
+            break;
+
+        n = next;
+    }
+}
@@ -0,0 +1,117 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+//std includes
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+//CHM includes
+#include "exception.hpp"
+#include "logger.hpp"
+#include "triangulation.hpp"
+#include "module_base.hpp"
+
+/**
+ * Dependency driven scheduler for the modules within a timestep.
+ *
+ * Each data parallel module is split into blocks of faces and each domain parallel module is a single node. Edges from the
+ * module dependency graph are mapped onto the nodes such that
+ *  - data -> data: block b waits only on block b of the upstream module, so faces flow through consecutive data modules without a barrier
+ *  - data -> domain: the domain module waits on every block of the upstream module
+ *  - domain -> data: every block waits on the domain module
+ *  - domain -> domain: direct edge
+ *
+ * Independent domain modules can therefore run alongside data parallel blocks. Nodes are run as OpenMP tasks, released
+ * when their dependency count reaches zero. Note that a domain module runs within a task, so any OpenMP parallel region
+ * internal to that module will only be given a single thread unless nested parallelism is enabled.
+ */
+class task_graph
+{
+  public:
+    task_graph();
+    ~task_graph();
+
+    /**
+     * Builds the task graph
+     * @param modules Modules in make order
+     * @param edges Dependency edges as (upstream module ID, downstream module ID)
+     * @param domain Mesh the modules run over
+     * @param block_size Number of faces per data parallel task
+     * @param trace_blocks Emit a profiler trace event for every data parallel block, otherwise they are summary-only as
+     * there are blocks x modules of them per timestep
+     */
+    void build(const std::vector<module>& modules,
+               const std::vector<std::pair<std::string, std::string>>& edges,
+               mesh& domain,
+               size_t block_size,
+               bool trace_blocks = false);
+
+    /**
+     * Runs all modules for one timestep. Rethrows the first exception raised by a module once all running tasks have finished.
+     * @param domain
+     */
+    void run(mesh& domain);
+
+    /**
+     * Number of nodes in the graph
+     * @return
+     */
+    size_t size();
+
+  private:
+
+    struct node
+    {
+        module m;
+        bool is_domain;
+        size_t begin; // face range [begin, end) for data nodes
+        size_t end;
+        std::vector<size_t> successors;
+        int n_predecessors;
+        size_t region; // profiler region
+        bool trace; // emit trace events for this node
+    };
+
+    // runs node n, then releases its successors. The first released successor is run inline on this thread
+    // to keep a block's faces hot in cache as it moves through consecutive data modules
+    void execute(size_t n);
+
+    std::vector<node> _nodes;
+    std::vector<size_t> _roots;
+    std::unique_ptr< std::atomic<int>[] > _remaining;
+
+    // once a module throws, the rest of the graph drains without running any further modules
+    std::atomic<bool> _failed;
+    std::unique_ptr<ompException> _exception;
+
+    // mesh for the current run
+    mesh _domain;
+};
@@ -0,0 +1,125 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "columnstorage.hpp"
+#include "gtest/gtest.h"
+
+class ColumnStorageTest : public testing::Test
+{
+  protected:
+
+    virtual void SetUp()
+    {
+        logging::core::get()->set_logging_enabled(false);
+
+        // some test variables
+        variables.insert("t");
+        variables.insert("rh");
+        variables.insert("vw");
+        variables.insert("p");
+    }
+
+    std::set< std::string> variables;
+};
+
+//basic default init sanity checks
+TEST_F(ColumnStorageTest, DefaultInit)
+{
+    columnstorage<double> c;
+    ASSERT_EQ(c.size() , 0);
+    ASSERT_EQ(c.rows() , 0);
+    ASSERT_EQ(c.variables().size() , 0);
+    ASSERT_FALSE(c.has("t"));
+    ASSERT_FALSE(c.has("t"_s));
+    ASSERT_THROW(c.resolve("t"_s), module_error);
+}
+
+TEST_F(ColumnStorageTest, Init)
+{
+    columnstorage<double> c;
+    c.init(variables, 10);
+
+    ASSERT_EQ(c.size() , 4);
+    ASSERT_EQ(c.rows() , 10);
+    ASSERT_EQ(c.variables().size() , 4);
+
+    for(size_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(c.at("t", i) , -9999);
+        ASSERT_EQ(c.at("p"_s, i) , -9999);
+    }
+
+    ASSERT_TRUE(c.has("rh"));
+    ASSERT_TRUE(c.has("vw"_s));
+    ASSERT_FALSE(c.has("swe"_s));
+}
+
+TEST_F(ColumnStorageTest, HandleAccess)
+{
+    columnstorage<double> c;
+    c.init(variables, 10);
+
+    auto t = c.resolve("t"_s);
+    auto rh = c.resolve("rh");
+    ASSERT_TRUE(t.valid());
+    ASSERT_EQ(c.name(t), "t");
+
+    for(size_t i = 0; i < 10; ++i)
+    {
+        c(t, i) = i;
+        c(rh, i) = 2. * i;
+    }
+
+    // handle, checked access and raw column all see the same data
+    double* col = c.column(rh);
+    for(size_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(c.at("t"_s, i) , i);
+        ASSERT_EQ(col[i] , 2. * i);
+    }
+}
+
+TEST_F(ColumnStorageTest, Throws)
+{
+    columnstorage<double> c;
+    c.init(variables, 10);
+
+    ASSERT_THROW(c.at("swe"_s, 0), module_error);
+    ASSERT_THROW(c.at("t"_s, 10), module_error);
+    ASSERT_THROW(c.resolve("swe"), module_error);
+}
+
+TEST_F(ColumnStorageTest, Reinit)
+{
+    columnstorage<double> c;
+    c.init(variables, 10);
+    c.at("t", 3) = 5;
+
+    std::set<std::string> other = {"swe"};
+    c.init(other, 3);
+
+    ASSERT_EQ(c.size() , 1);
+    ASSERT_EQ(c.rows() , 3);
+    ASSERT_FALSE(c.has("t"));
+    ASSERT_EQ(c.at("swe", 2) , -9999);
+}
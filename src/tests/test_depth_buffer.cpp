@@ -0,0 +1,87 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "math/depth_buffer.hpp"
+#include "gtest/gtest.h"
+
+// two unit squares made of two triangles each, one above the other in z
+class DepthBufferTest : public ::testing::Test
+{
+  protected:
+    void add_square(double x0, double y0, double size, double depth)
+    {
+        int base = x.size();
+        x.insert(x.end(), {x0, x0 + size, x0 + size, x0});
+        y.insert(y.end(), {y0, y0, y0 + size, y0 + size});
+        z.insert(z.end(), {depth, depth, depth, depth});
+        triangles.push_back({base, base + 1, base + 2});
+        triangles.push_back({base, base + 2, base + 3});
+    }
+
+    std::vector<double> x, y, z;
+    std::vector<std::array<int, 3>> triangles;
+};
+
+TEST_F(DepthBufferTest, CloserTriangleOccludes)
+{
+    add_square(0, 0, 1, 0); // far
+    add_square(0, 0, 1, 1); // near, covers the far square
+
+    math::depth_buffer buffer(x, y, z, triangles, 64, 16);
+    buffer.render();
+    auto fraction = buffer.occluded_fraction(1e-6);
+
+    EXPECT_DOUBLE_EQ(fraction[0], 1.0);
+    EXPECT_DOUBLE_EQ(fraction[1], 1.0);
+    EXPECT_DOUBLE_EQ(fraction[2], 0.0);
+    EXPECT_DOUBLE_EQ(fraction[3], 0.0);
+
+    EXPECT_FLOAT_EQ(buffer.depth(10, 10), 1.0f);
+}
+
+TEST_F(DepthBufferTest, PartialOcclusion)
+{
+    add_square(0, 0, 2, 0);   // far
+    add_square(0, 0, 1, 1);   // near, covers a quarter of the far square
+
+    math::depth_buffer buffer(x, y, z, triangles, 128, 16);
+    buffer.render();
+    auto fraction = buffer.occluded_fraction(1e-6);
+
+    double far = (fraction[0] + fraction[1]) / 2.;
+    EXPECT_NEAR(far, 0.25, 0.02);
+    EXPECT_DOUBLE_EQ(fraction[2], 0.0);
+}
+
+TEST_F(DepthBufferTest, DisjointUnoccluded)
+{
+    add_square(0, 0, 1, 0);
+    add_square(2, 0, 1, 5);
+
+    math::depth_buffer buffer(x, y, z, triangles, 100);
+    buffer.render();
+    auto fraction = buffer.occluded_fraction(1e-6);
+
+    for (auto f : fraction)
+        EXPECT_DOUBLE_EQ(f, 0.0);
+}
@@ -0,0 +1,68 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "horizon_map.hpp"
+#include "gtest/gtest.h"
+
+TEST(HorizonMap, QuantizationRoundTrip)
+{
+    horizon_map map(2, 4, 1000.);
+    map.set(1, 2, 0.3);
+    EXPECT_NEAR(map.angle(1, 2), 0.3, M_PI_2 / 65535.);
+    EXPECT_EQ(map.angle(0, 2), 0.);
+
+    // clamped to [0, pi/2]
+    map.set(0, 0, -1.);
+    map.set(0, 1, 4.);
+    EXPECT_EQ(map.angle(0, 0), 0.);
+    EXPECT_NEAR(map.angle(0, 1), M_PI_2, 1e-12);
+}
+
+TEST(HorizonMap, InterpolatesBetweenSectorsAndWraps)
+{
+    // sectors centred on 0, 90, 180, 270
+    horizon_map map(1, 4, 1000.);
+    map.set(0, 0, 0.2);
+    map.set(0, 1, 0.4);
+    map.set(0, 3, 0.6);
+
+    double eps = 1e-4;
+    EXPECT_NEAR(map.angle_at(0, 0.), 0.2, eps);
+    EXPECT_NEAR(map.angle_at(0, 45.), 0.3, eps);
+    EXPECT_NEAR(map.angle_at(0, 315.), 0.4, eps); // between 270 and 360 == 0
+    EXPECT_NEAR(map.angle_at(0, -45.), 0.4, eps);
+    EXPECT_NEAR(map.angle_at(0, 360.), 0.2, eps);
+}
+
+TEST(HorizonMap, SkyViewFactor)
+{
+    horizon_map map(2, 36, 1000.);
+
+    // flat and unobstructed sees the whole sky
+    EXPECT_NEAR(map.svf(0, 0., 0.), 1., 1e-12);
+
+    // a uniform horizon of phi on flat ground gives cos^2(phi)
+    for (size_t k = 0; k < 36; k++)
+        map.set(1, k, 0.5);
+    EXPECT_NEAR(map.svf(1, 0., 0.), cos(map.angle(1, 0)) * cos(map.angle(1, 0)), 1e-12);
+}
@@ -23,6 +23,7 @@
 
 
 #include "interpolation.hpp"
+#include "math/expint.hpp"
 #include "logger.hpp"
 #include <vector>
 #include <boost/tuple/tuple.hpp>
@@ -86,6 +87,58 @@ TEST_F(InterpTest,spline2)
 
 }
 
+TEST_F(InterpTest,spline_shared_factorization)
+{
+    thin_plate_spline::trim_shared_factorizations(0);
+
+    std::vector<boost::tuple<double,double,double> > xy;
+
+    xy.push_back( boost::make_tuple(-1276639.4142831599,1408220.6433826166,22.241299818717572));
+    xy.push_back( boost::make_tuple(-1276628.96002623, 1408213.5776356135, 22.423794697169313));
+    xy.push_back( boost::make_tuple(-1276628.8896492834,1408225.6645281466,22.301020204404736));
+
+    auto query = boost::make_tuple(-1276633.6294519969,1408220.6575855566,2306.0533040364585);
+
+    thin_plate_spline s1, s2;
+    thin_plate_spline unshared(3, {{"share_LU","false"}});
+
+    // the same stations share one factorization and give the same result as an unshared spline
+    double result = s1(xy,query);
+    ASSERT_DOUBLE_EQ(s2(xy,query),result);
+    ASSERT_DOUBLE_EQ(unshared(xy,query),result);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),1);
+
+    // within the budget nothing is released
+    size_t three_stations = thin_plate_spline::shared_factorization_bytes();
+    ASSERT_GT(three_stations,0);
+    thin_plate_spline::trim_shared_factorizations(three_stations);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),1);
+
+    // dropping a station is a different system, factored in a later timestep
+    auto all = xy;
+    xy.pop_back();
+    s1(xy,query);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),2);
+    size_t two_stations = thin_plate_spline::shared_factorization_bytes() - three_stations;
+    ASSERT_LT(two_stations,three_stations);
+
+    // over the budget the least recently used one goes
+    thin_plate_spline::trim_shared_factorizations(three_stations);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),1);
+    ASSERT_EQ(thin_plate_spline::shared_factorization_bytes(),two_stations);
+
+    // using the three stations again makes the two station one the oldest
+    s1(all,query);
+    thin_plate_spline::trim_shared_factorizations(two_stations + three_stations);
+    s1(all,query);
+    thin_plate_spline::trim_shared_factorizations(three_stations);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),1);
+    ASSERT_EQ(thin_plate_spline::shared_factorization_bytes(),three_stations);
+
+    thin_plate_spline::trim_shared_factorizations(0);
+    ASSERT_EQ(thin_plate_spline::shared_factorizations(),0);
+}
+
 TEST_F(InterpTest,spline_forcedsize)
 {
     thin_plate_spline s(5);
@@ -165,3 +218,256 @@ TEST_F(InterpTest,interpolation_class_static_size2)
 
 
 }
+
+TEST_F(InterpTest,idw_weights)
+{
+    // 3 stations, 2 query points: one using all the stations, one on top of station 2
+    std::vector<double> sx{0., 10., 0.};
+    std::vector<double> sy{0., 0., 10.};
+    std::vector<double> qx{2., 0.};
+    std::vector<double> qy{3., 10.};
+    std::vector<size_t> offsets{0, 3, 5};
+    std::vector<uint32_t> stations{0, 1, 2, 1, 2};
+
+    idw_weights w;
+    w.init(offsets, stations, sx, sy, qx, qy);
+
+    std::vector<double> values{1., 2., 3.};
+
+    // same as the per-call idw
+    inv_dist idw;
+    std::vector<boost::tuple<double,double,double> > xy;
+    for (size_t i = 0; i < 3; i++)
+        xy.push_back(boost::make_tuple(sx[i], sy[i], values[i]));
+    auto query = boost::make_tuple(2., 3., 0.);
+
+    ASSERT_DOUBLE_EQ(w(0, values.data()), idw(xy, query));
+    ASSERT_DOUBLE_EQ(w(1, values.data()), 3.);
+    ASSERT_EQ(w.nearest(0), 0);
+    ASSERT_EQ(w.nearest(1), 2);
+
+    // a nan station is dropped and the rest renormalized, same as leaving it out of the sample points
+    values[1] = nan("");
+    xy.erase(xy.begin() + 1);
+
+    std::vector<double> out(2);
+    w.interpolate(values.data(), out.data());
+    ASSERT_DOUBLE_EQ(out[0], idw(xy, query));
+}
+
+TEST_F(InterpTest,idw_weights_nan_on_station)
+{
+    // a query point on top of station 0, which falls back to the other stations when it is nan
+    std::vector<double> sx{0., 10., 0.};
+    std::vector<double> sy{0., 0., 10.};
+    std::vector<double> qx{0.};
+    std::vector<double> qy{0.};
+
+    idw_weights w;
+    w.init({0, 3}, {0, 1, 2}, sx, sy, qx, qy);
+    ASSERT_EQ(w.nearest(0), 0);
+
+    std::vector<double> values{1., 2., 4.};
+    ASSERT_DOUBLE_EQ(w(0, values.data()), 1.);
+
+    // stations 1 and 2 are the same distance away
+    values[0] = nan("");
+    ASSERT_DOUBLE_EQ(w(0, values.data()), 3.);
+
+    // per variable, variable 0 is nan on the station and variable 1 isn't
+    std::vector<double> multi{nan(""), 5., 2., 6., 4., 7.};
+    double out[2];
+    w(0, multi.data(), 2, out);
+    ASSERT_DOUBLE_EQ(out[0], 3.);
+    ASSERT_DOUBLE_EQ(out[1], 5.);
+}
+
+TEST_F(InterpTest,multi_variable)
+{
+    // two variables at the same stations give the same result as two single-variable calls
+    std::vector<boost::tuple<double,double,double> > a, b, xy;
+    a.push_back( boost::make_tuple(69.,76.,20.820));
+    a.push_back( boost::make_tuple(59.,64.,10.910 ));
+    a.push_back( boost::make_tuple(75.,52.,10.380 ));
+    a.push_back( boost::make_tuple(86.,73.,14.600 ));
+    a.push_back( boost::make_tuple(88.,53.,10.560 ));
+
+    std::vector<double> values;
+    for (auto& p : a)
+    {
+        double z = 1000. - 3. * p.get<2>();
+        b.push_back( boost::make_tuple(p.get<0>(), p.get<1>(), z));
+        xy.push_back( boost::make_tuple(p.get<0>(), p.get<1>(), 0.));
+        values.push_back(p.get<2>());
+        values.push_back(z);
+    }
+
+    auto query = boost::make_tuple(69.,67.,0.);
+
+    for (auto alg : {interp_alg::tpspline, interp_alg::idw})
+    {
+        interpolation s(alg);
+        double out[2];
+        s(xy, values, 2, query, out);
+
+        ASSERT_NEAR(out[0], s(a, query), 1e-9);
+        ASSERT_NEAR(out[1], s(b, query), 1e-9);
+    }
+
+    interpolation s(interp_alg::idw);
+    double out[2];
+    values.pop_back();
+    ASSERT_THROW(s(xy, values, 2, query, out), interpolation_error);
+}
+
+TEST_F(InterpTest,ein_approximation)
+{
+    // against GSL over the range of kernel arguments, log spaced
+    std::vector<double> t;
+    for (double v = 1e-6; v < 600.; v *= 1.01)
+        t.push_back(v);
+    t.push_back(4.); // the switch between the two series
+    t.push_back(std::nextafter(4., 5.));
+
+    std::vector<double> out(t.size());
+    math::ein(t.data(), out.data(), t.size());
+
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        double reference = log(t[i]) + math::euler_gamma + gsl_sf_expint_E1(t[i]);
+        ASSERT_NEAR(out[i], reference, 1e-13) << "t = " << t[i];
+        ASSERT_EQ(out[i], math::ein(t[i]));
+    }
+
+    // the limit rather than nan
+    ASSERT_NEAR(math::ein(0.), 0., 1e-14);
+}
+
+TEST_F(InterpTest,spline_gsl_kernel)
+{
+    std::vector<boost::tuple<double,double,double> > xy;
+
+    xy.push_back( boost::make_tuple(69.,76.,20.820));
+    xy.push_back( boost::make_tuple(59.,64.,10.910 ));
+    xy.push_back( boost::make_tuple(75.,52.,10.380 ));
+    xy.push_back( boost::make_tuple(86.,73.,14.600 ));
+    xy.push_back( boost::make_tuple(88.,53.,10.560 ));
+
+    auto query = boost::make_tuple(69.,67.,0.);
+
+    thin_plate_spline approx;
+    thin_plate_spline reference(0, {{"kernel","gsl"}});
+
+    ASSERT_NEAR(approx(xy, query), reference(xy, query), 1e-9);
+}
+
+TEST_F(InterpTest,sample_view)
+{
+    std::vector<boost::tuple<double,double,double> > xy;
+    xy.push_back( boost::make_tuple(69.,76.,20.820));
+    xy.push_back( boost::make_tuple(59.,64.,10.910 ));
+    xy.push_back( boost::make_tuple(75.,52.,10.380 ));
+    xy.push_back( boost::make_tuple(86.,73.,14.600 ));
+    xy.push_back( boost::make_tuple(88.,53.,10.560 ));
+
+    auto query = boost::make_tuple(69.,67.,0.);
+
+    for (auto alg : {interp_alg::tpspline, interp_alg::idw})
+    {
+        interpolation s(alg);
+
+        // reused after a clear, as the modules do each face
+        interp_samples samples;
+        samples.push_back(1., 2., 3.);
+        samples.values.push_back(4.);
+        samples.clear();
+        ASSERT_EQ(samples.size(), 0u);
+
+        for (auto& p : xy)
+        {
+            samples.push_back(p.get<0>(), p.get<1>(), p.get<2>());
+            samples.values.push_back(p.get<2>());
+            samples.values.push_back(-p.get<2>());
+        }
+
+        ASSERT_DOUBLE_EQ(s(samples.view(), query), s(xy, query));
+
+        double out[2];
+        s(samples.view(), samples.values.data(), 2, query, out);
+        ASSERT_NEAR(out[0], s(xy, query), 1e-9);
+        ASSERT_NEAR(out[1], -s(xy, query), 1e-9);
+    }
+
+    interp_samples empty;
+    interpolation s(interp_alg::idw);
+    ASSERT_THROW(s(empty.view(), query), config_error);
+}
+
+TEST_F(InterpTest,bilinear)
+{
+    // a warped cell, corners in grid order, and an axis aligned one for which the bilinear map is linear
+    std::vector< std::vector<double> > cells_x{ {0., 10., 1., 12.}, {0., 10., 0., 10.} };
+    std::vector< std::vector<double> > cells_y{ {0., 1., 10., 13.}, {0., 0., 10., 10.} };
+
+    for (size_t c = 0; c < cells_x.size(); c++)
+    {
+        const double* x = cells_x[c].data();
+        const double* y = cells_y[c].data();
+
+        for (double u : {0., 0.25, 0.7, 1.})
+        {
+            for (double v : {0., 0.4, 0.9})
+            {
+                double qx = (1-u)*(1-v)*x[0] + u*(1-v)*x[1] + (1-u)*v*x[2] + u*v*x[3];
+                double qy = (1-u)*(1-v)*y[0] + u*(1-v)*y[1] + (1-u)*v*y[2] + u*v*y[3];
+
+                double cu, cv;
+                ASSERT_TRUE(bilinear::cell_coordinates(x, y, qx, qy, cu, cv));
+                ASSERT_NEAR(cu, u, 1e-12);
+                ASSERT_NEAR(cv, v, 1e-12);
+
+                // exact for a function that is bilinear in the cell coordinates
+                bilinear b;
+                interp_samples samples;
+                for (size_t k = 0; k < 4; k++)
+                    samples.push_back(x[k], y[k], 2. + 3. * (k & 1) - (k >> 1) + 5. * (k == 3));
+
+                ASSERT_NEAR(b(samples.view(), boost::make_tuple(qx, qy, 0.)), 2. + 3.*u - v + 5.*u*v, 1e-12);
+            }
+        }
+    }
+
+    // outside of the cell the closest edge is used
+    double x[4] = {0., 10., 0., 10.};
+    double y[4] = {0., 0., 10., 10.};
+    double u, v;
+    ASSERT_FALSE(bilinear::cell_coordinates(x, y, 15., 5., u, v));
+    ASSERT_NEAR(u, 1.5, 1e-12);
+
+    double w[4];
+    bilinear::weights(x, y, 15., 5., w);
+    ASSERT_NEAR(w[0], 0., 1e-12);
+    ASSERT_NEAR(w[1], 0.5, 1e-12);
+    ASSERT_NEAR(w[2], 0., 1e-12);
+    ASSERT_NEAR(w[3], 0.5, 1e-12);
+
+    // the precomputed weights give the same result as the interpolant
+    std::vector<double> values{1., 2., 3., 4.};
+    bilinear::weights(x, y, 2., 7., w);
+    idw_weights table;
+    table.init({0, 4}, {0, 1, 2, 3}, std::vector<double>(w, w + 4));
+    ASSERT_EQ(table.nearest(0), 2);
+
+    interpolation s(interp_alg::bilinear_grid);
+    interp_samples samples;
+    for (size_t k = 0; k < 4; k++)
+        samples.push_back(x[k], y[k], values[k]);
+    auto query = boost::make_tuple(2., 7., 0.);
+    ASSERT_DOUBLE_EQ(table(0, values.data()), s(samples.view(), query));
+
+    // without a full cell it falls back to idw
+    samples.clear();
+    for (size_t k = 0; k < 3; k++)
+        samples.push_back(x[k], y[k], values[k]);
+    ASSERT_DOUBLE_EQ(s(samples.view(), query), inv_dist()(samples.view(), query));
+}
@@ -0,0 +1,152 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "mesh_cache.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+class MeshCache : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        path = testing::TempDir() + "test_mesh_cache.bin";
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+TEST_F(MeshCache, RoundTrip)
+{
+    std::vector<double> xyz{1.5, 2.5, 3.5, 4.5, 5.5, 6.5};
+    std::vector<int32_t> elem{0, 1, 2}; // odd byte length, exercises the padding
+
+    {
+        mesh_cache::writer w(path, 42, mesh_cache::flag_geographic);
+        w.write<uint64_t>(7);
+        w.write_string("proj");
+        w.write_array(elem);
+        w.write_array(xyz);
+        w.close();
+    }
+
+    mesh_cache::reader r;
+    ASSERT_TRUE(r.open(path, 42));
+    EXPECT_EQ(r.flags(), mesh_cache::flag_geographic);
+    EXPECT_EQ(r.read<uint64_t>(), 7u);
+    EXPECT_EQ(r.read_string(), "proj");
+    EXPECT_EQ(r.read_vector<int32_t>(), elem);
+
+    size_t n;
+    const double* p = r.read_array<double>(n);
+    ASSERT_EQ(n, xyz.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(double), 0u);
+    for (size_t i = 0; i < n; i++)
+        EXPECT_EQ(p[i], xyz[i]);
+}
+
+TEST_F(MeshCache, RejectsStaleOrMissing)
+{
+    mesh_cache::reader r;
+    EXPECT_FALSE(r.open(path, 42));
+
+    {
+        mesh_cache::writer w(path, 42);
+        w.write<uint64_t>(1);
+        w.close();
+    }
+    EXPECT_FALSE(r.open(path, 43));
+    EXPECT_TRUE(r.open(path, 42));
+}
+
+TEST_F(MeshCache, AbandonedWriteLeavesNoFile)
+{
+    {
+        mesh_cache::writer w(path, 1);
+        w.write<uint64_t>(1);
+    }
+    mesh_cache::reader r;
+    EXPECT_FALSE(r.open(path, 1));
+}
+
+TEST_F(MeshCache, TruncatedReadThrows)
+{
+    {
+        mesh_cache::writer w(path, 1);
+        w.write<uint64_t>(1);
+        w.close();
+    }
+    mesh_cache::reader r;
+    ASSERT_TRUE(r.open(path, 1));
+    r.read<uint64_t>();
+    EXPECT_ANY_THROW(r.read<uint64_t>());
+}
+
+TEST_F(MeshCache, TruncatedHeaderIsAMiss)
+{
+    {
+        mesh_cache::writer w(path, 1);
+        w.close();
+    }
+
+    // cut inside the input hash
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ASSERT_EQ(bytes.size(), 32);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), 28);
+    }
+
+    mesh_cache::reader r;
+    ASSERT_FALSE(r.open(path, 1));
+}
+
+TEST_F(MeshCache, HashFollowsFileContents)
+{
+    auto write = [&](const std::string& text)
+    {
+        std::ofstream out(path);
+        out << text;
+    };
+
+    write("mesh a");
+    auto a = mesh_cache::hash_files({path}, 0);
+    EXPECT_EQ(a, mesh_cache::hash_files({path}, 0));
+    EXPECT_NE(a, mesh_cache::hash_files({path}, 1));
+
+    write("mesh b");
+    EXPECT_NE(a, mesh_cache::hash_files({path}, 0));
+}
@@ -0,0 +1,107 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "partitioner.hpp"
+#include "gtest/gtest.h"
+
+#include <set>
+
+// n x n grid of vertices with 4-neighbour edges, numbered row by row
+static partitioner::graph grid(size_t n)
+{
+    partitioner::graph g;
+    g.xadj.push_back(0);
+    for (size_t y = 0; y < n; y++)
+    {
+        for (size_t x = 0; x < n; x++)
+        {
+            if (x > 0) g.adjncy.push_back(y * n + x - 1);
+            if (x + 1 < n) g.adjncy.push_back(y * n + x + 1);
+            if (y > 0) g.adjncy.push_back((y - 1) * n + x);
+            if (y + 1 < n) g.adjncy.push_back((y + 1) * n + x);
+            g.xadj.push_back(g.adjncy.size());
+            g.xy.push_back({{ double(x), double(y) }});
+        }
+    }
+    return g;
+}
+
+TEST(Partitioner, BlockMatchesContiguousRanges)
+{
+    auto g = grid(3);
+    auto part = partitioner::partition(g, 2, partitioner::method::block);
+    std::vector<int> expected = {0, 0, 0, 0, 0, 1, 1, 1, 1};
+    EXPECT_EQ(expected, part);
+}
+
+TEST(Partitioner, BisectionIsBalancedWithSmallCut)
+{
+    const size_t n = 64;
+    auto g = grid(n);
+
+    for (int nparts : {2, 3, 4, 8})
+    {
+        auto part = partitioner::partition(g, nparts, partitioner::method::bisection);
+
+        std::set<int> used(part.begin(), part.end());
+        EXPECT_EQ(size_t(nparts), used.size());
+        EXPECT_LT(partitioner::imbalance(g, part, nparts), 1.05);
+
+        // never worse than the row blocks
+        auto block = partitioner::partition(g, nparts, partitioner::method::block);
+        EXPECT_LE(partitioner::edge_cut(g, part), partitioner::edge_cut(g, block));
+    }
+
+    // 2 parts of a square should be a straight(ish) cut of about n edges
+    auto part = partitioner::partition(g, 2, partitioner::method::bisection);
+    EXPECT_LE(partitioner::edge_cut(g, part), 2 * n);
+}
+
+TEST(Partitioner, BisectionWithoutCoordinates)
+{
+    auto g = grid(32);
+    g.xy.clear();
+
+    auto part = partitioner::partition(g, 4, partitioner::method::bisection);
+    std::set<int> used(part.begin(), part.end());
+    EXPECT_EQ(size_t(4), used.size());
+    EXPECT_LT(partitioner::imbalance(g, part, 4), 1.05);
+}
+
+TEST(Partitioner, RespectsWeights)
+{
+    auto g = grid(32);
+    g.weight.assign(g.size(), 1.0);
+    // the first half of the rows are 3x as expensive
+    for (size_t v = 0; v < g.size() / 2; v++)
+        g.weight[v] = 3.0;
+
+    auto part = partitioner::partition(g, 4, partitioner::method::bisection);
+    EXPECT_LT(partitioner::imbalance(g, part, 4), 1.05);
+}
+
+TEST(Partitioner, UnknownMethodThrows)
+{
+    EXPECT_EQ(partitioner::method::bisection, partitioner::from_string("bisection"));
+    EXPECT_THROW(partitioner::from_string("spectral"), config_error);
+}
@@ -0,0 +1,89 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "space_filling_curve.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <set>
+
+TEST(SpaceFillingCurve, HilbertFirstOrder)
+{
+    // order 1 curve visits (0,0) (0,1) (1,1) (1,0)
+    EXPECT_EQ(0u, sfc::hilbert(0, 0, 1));
+    EXPECT_EQ(1u, sfc::hilbert(0, 1, 1));
+    EXPECT_EQ(2u, sfc::hilbert(1, 1, 1));
+    EXPECT_EQ(3u, sfc::hilbert(1, 0, 1));
+}
+
+TEST(SpaceFillingCurve, HilbertIsContinuous)
+{
+    // consecutive cells along the curve are always grid neighbours
+    const unsigned int order = 4;
+    const uint32_t n = 1 << order;
+    std::vector< std::pair<int, int> > cell(n * n);
+    for (uint32_t x = 0; x < n; x++)
+        for (uint32_t y = 0; y < n; y++)
+            cell.at(sfc::hilbert(x, y, order)) = std::make_pair(int(x), int(y));
+
+    for (size_t d = 1; d < cell.size(); d++)
+    {
+        int dist = std::abs(cell[d].first - cell[d - 1].first) + std::abs(cell[d].second - cell[d - 1].second);
+        EXPECT_EQ(1, dist);
+    }
+}
+
+TEST(SpaceFillingCurve, Morton)
+{
+    EXPECT_EQ(0u, sfc::morton(0, 0));
+    EXPECT_EQ(1u, sfc::morton(1, 0));
+    EXPECT_EQ(2u, sfc::morton(0, 1));
+    EXPECT_EQ(3u, sfc::morton(1, 1));
+    EXPECT_EQ(0xAAAAAAAAAAAAAAAAull, sfc::morton(0, 0xFFFFFFFF));
+}
+
+TEST(SpaceFillingCurve, OrderIsPermutation)
+{
+    std::vector< std::array<double, 2> > pts;
+    for (int i = 0; i < 100; i++)
+        pts.push_back({{ double((i * 37) % 100), double((i * 59) % 100) }});
+
+    for (auto c : {sfc::curve::hilbert, sfc::curve::morton})
+    {
+        auto p = sfc::order(pts, c);
+        ASSERT_EQ(pts.size(), p.size());
+        std::set<size_t> unique(p.begin(), p.end());
+        EXPECT_EQ(pts.size(), unique.size());
+        EXPECT_EQ(pts.size() - 1, *unique.rbegin());
+    }
+
+    auto identity = sfc::order(pts, sfc::curve::none);
+    for (size_t i = 0; i < identity.size(); i++)
+        EXPECT_EQ(i, identity[i]);
+}
+
+TEST(SpaceFillingCurve, UnknownCurveThrows)
+{
+    EXPECT_EQ(sfc::curve::hilbert, sfc::from_string("hilbert"));
+    EXPECT_THROW(sfc::from_string("peano"), config_error);
+}
@@ -26,6 +26,8 @@
 #include "triangulation.hpp"
 #include "gtest/gtest.h"
 #include "readjson.hpp"
+#include "mesh_cache.hpp"
+#include <cstdio>
 #include <boost/property_tree/ptree.hpp>
 
 struct test_module_data : face_info
@@ -59,11 +61,29 @@ class TriangulationTest : public testing::Test
             std::string key = ktr.first.data();
             mesh_json.put_child( "initial_conditions." + key ,ktr.second);
         }
+
+        // as core does before loading the mesh
+        use_distance_functions(mesh_json.get<int>("mesh.is_geographic") == 1);
+
         mesh.from_json(mesh_json);
         mesh.init_timeseries(variables);
 
     }
 
+    static void use_distance_functions(bool is_geographic)
+    {
+        if(is_geographic)
+        {
+            math::gis::point_from_bearing = &math::gis::point_from_bearing_latlong;
+            math::gis::distance = &math::gis::distance_latlong;
+        }
+        else
+        {
+            math::gis::point_from_bearing = &math::gis::point_from_bearing_UTM;
+            math::gis::distance = &math::gis::distance_UTM;
+        }
+    }
+
     pt::ptree mesh_json;
     pt::ptree param_json;
     pt::ptree ic_json;
@@ -183,4 +203,88 @@ TEST_F(TriangulationTest, ModuleData)
 
 
 
-}
\ No newline at end of file
+}
+
+TEST_F(TriangulationTest, LoadFromCache)
+{
+    std::string path = testing::TempDir() + "test_triangulation_cache.bin";
+    std::remove(path.c_str());
+    mesh.write_cache(path, 42);
+
+    // a new run starts without the distance functions, which loading the cache needs
+    math::gis::distance.clear();
+    math::gis::point_from_bearing.clear();
+
+    triangulation cached;
+    ASSERT_THROW(cached.from_cache(path, 42), mesh_error);
+
+    // as core does on a cache hit: the header says how to set up the distance functions, then the mesh is loaded
+    mesh_cache::reader header;
+    ASSERT_TRUE(header.open(path, 42));
+    bool is_geographic = (header.flags() & mesh_cache::flag_geographic) != 0;
+    header.close();
+    ASSERT_EQ(is_geographic, mesh.is_geographic());
+
+    use_distance_functions(is_geographic);
+    ASSERT_TRUE(cached.from_cache(path, 42));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(cached.size_faces(), mesh.size_faces());
+    ASSERT_DOUBLE_EQ(cached.face(1)->parameter("MS0"), mesh.face(1)->parameter("MS0"));
+
+    auto& a = mesh.geometry();
+    auto& b = cached.geometry();
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        ASSERT_DOUBLE_EQ(a.area[i], b.area[i]);
+        for (int j = 0; j < 3; j++)
+        {
+            ASSERT_EQ(a.neighbor[i][j], b.neighbor[i][j]);
+            ASSERT_DOUBLE_EQ(a.neighbor_distance[i][j], b.neighbor_distance[i][j]);
+        }
+    }
+}
+
+TEST_F(TriangulationTest, WriteParametersReordered)
+{
+    std::string base = testing::TempDir() + "test_triangulation_reorder";
+    mesh.to_hdf5(base);
+
+    // the faces are in curve order internally, the parameter file has to be in the mesh file's order
+    triangulation reordered;
+    reordered.set_reorder_curve(sfc::curve::hilbert);
+    reordered.from_hdf5(base + "_mesh.h5", {base + "_param.h5"}, {});
+
+    for (size_t i = 0; i < reordered.size_faces(); i++)
+    {
+        auto f = reordered.face(i);
+        f->parameter("MS0") = f->center().x();
+    }
+
+    // a mesh loaded from the cache is also in curve order, and has to know the file order too
+    reordered.write_cache(base + "_cache.bin", 7);
+    triangulation cached;
+    ASSERT_TRUE(cached.from_cache(base + "_cache.bin", 7));
+
+    for (auto source : {&reordered, &cached})
+    {
+        source->write_parameters_hdf5(base + "_written.h5", {"MS0"});
+
+        for (auto curve : {sfc::curve::none, sfc::curve::hilbert})
+        {
+            triangulation loaded;
+            loaded.set_reorder_curve(curve);
+            loaded.from_hdf5(base + "_mesh.h5", {base + "_written.h5"}, {});
+
+            for (size_t i = 0; i < loaded.size_faces(); i++)
+            {
+                auto f = loaded.face(i);
+                ASSERT_DOUBLE_EQ(f->parameter("MS0"), f->center().x());
+            }
+        }
+    }
+
+    for (auto suffix : {"_mesh.h5", "_param.h5", "_written.h5", "_cache.bin"})
+        std::remove((base + suffix).c_str());
+}
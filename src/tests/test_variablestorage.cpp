@@ -142,4 +142,27 @@ TEST_F(VariableStorageTest, uninit)
 {
     variablestorage<double> v;
     ASSERT_ANY_THROW(v["t"] = 1);
-}
\ No newline at end of file
+}
+TEST_F(VariableStorageTest, handle)
+{
+    variablestorage<double> v (variables);
+    variablestorage<double> w (variables);
+
+    auto h = v.resolve("rh");
+    v[h] = 2;
+    ASSERT_EQ(v["rh"], 2);
+
+    // the same variables share the slots
+    w["rh"] = 3;
+    ASSERT_EQ(w[h], 3);
+
+    // a storage with other variables falls back to the lookup
+    std::set<std::string> more = variables;
+    more.insert("swe");
+    more.insert("ilwr");
+    variablestorage<double> x (more);
+    x["rh"] = 4;
+    ASSERT_EQ(x[h], 4);
+
+    ASSERT_ANY_THROW(v.resolve("tttt"));
+}
@@ -0,0 +1,307 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+// hash functions
+#include "utility/BBhash.h"
+#include "utility/wyhash.h"
+#include "utility/xxh64.hpp"
+
+#include "logger.hpp"
+#include "exception.hpp"
+
+#include <string>
+#include <vector>
+#include <set>
+#include <limits>
+#include <memory>
+
+/// Handle to a column (variable) in a columnstorage. Obtained once via columnstorage::resolve
+/// and then used to index the column directly, avoiding the per-access hash lookup.
+struct column_handle
+{
+    static const size_t npos = std::numeric_limits<size_t>::max();
+
+    column_handle() : slot(npos) {}
+    explicit column_handle(size_t s) : slot(s) {}
+
+    bool valid() const { return slot != npos; }
+
+    size_t slot;
+};
+
+/// Structure-of-arrays storage for per-face variables.
+/// Each variable is held in its own contiguous column of length rows(), and a row corresponds to a face's cell_local_id.
+/// Variable names are mapped to columns with the same MPHF + xxhash check used by variablestorage.
+template<typename T = double>
+class columnstorage
+{
+  public:
+    columnstorage();
+    ~columnstorage();
+
+    /// Initialize the storage with a set of variables, each with nrows entries. Values default to -9999
+    /// Any previously held data is discarded.
+    /// @param variables
+    /// @param nrows
+    void init(const std::set<std::string>& variables, size_t nrows);
+
+    /// Resolve a variable to a column handle. Use _s for compile-time hash.
+    /// Throws if the variable does not exist.
+    /// @param hash
+    /// @return
+    column_handle resolve(const uint64_t& hash) const;
+    column_handle resolve(const std::string& variable) const;
+
+    /// Determine if a variable is in the storage. Uses _s for compile time hash
+    /// @param hash
+    /// @return
+    bool has(const uint64_t& hash) const;
+    bool has(const std::string& variable) const;
+
+    /// Unchecked access to the value of a resolved variable at row
+    /// @param h
+    /// @param row
+    /// @return
+    inline T& operator()(const column_handle& h, size_t row)
+    {
+        return _columns[h.slot][row];
+    }
+
+    /// Checked access to the value of a variable at row. Use _s for compile-time hash.
+    /// Throws if not found or init not yet called.
+    /// @param hash
+    /// @param row
+    /// @return
+    T& at(const uint64_t& hash, size_t row);
+    T& at(const std::string& variable, size_t row);
+
+    /// Raw pointer to the start of the column, for tight loops over all rows
+    /// @param h
+    /// @return
+    T* column(const column_handle& h);
+
+    /// Returns a list of the variables stored
+    /// @return
+    std::vector<std::string> variables() const;
+
+    /// Returns the variable name for a handle
+    /// @param h
+    /// @return
+    const std::string& name(const column_handle& h) const;
+
+    /// Returns the number of variables stored
+    /// @return
+    size_t size() const;
+
+    /// Returns the length of each column
+    /// @return
+    size_t rows() const;
+
+  private:
+
+    template <typename Item> class wyandFunctor
+    {
+      public:
+        uint64_t operator ()  (const Item& key, uint64_t seed = 2654435761U) const
+        {
+            return wyhash(&key, sizeof(Item), seed);
+        }
+
+    };
+    typedef wyandFunctor<uint64_t> hasher_t;
+    typedef boomphf::mphf< uint64_t, hasher_t  > boophf_t;
+
+    // returns npos if not found
+    size_t lookup(const uint64_t& hash) const;
+
+    T get_default_value() const;
+
+    std::unique_ptr<boophf_t> _variable_bphf;
+
+    // per column: the xxhash (to confirm the mphf result) and the name
+    std::vector<uint64_t> _hashes;
+    std::vector<std::string> _names;
+
+    // one contiguous array per variable
+    std::vector< std::vector<T> > _columns;
+
+    size_t _size;
+    size_t _rows;
+};
+
+template<typename T>
+columnstorage<T>::columnstorage()
+{
+    _size = 0;
+    _rows = 0;
+    _variable_bphf = nullptr;
+}
+
+template<typename T>
+columnstorage<T>::~columnstorage()
+{
+
+}
+
+template<typename T>
+void columnstorage<T>::init(const std::set<std::string>& variables, size_t nrows)
+{
+    std::vector<u_int64_t> hash_vec;
+    for(auto& v : variables)
+    {
+        uint64_t hash = xxh64::hash (v.c_str(), v.length());
+        hash_vec.push_back(hash);
+    }
+
+    _variable_bphf = std::unique_ptr<boophf_t>(
+        new boophf_t(hash_vec.size(),hash_vec,1,2,false,false));
+
+    _hashes.assign(variables.size(), 0);
+    _names.assign(variables.size(), "");
+    _columns.clear();
+    _columns.resize(variables.size());
+
+    for(auto& v : variables)
+    {
+        uint64_t hash = xxh64::hash (v.c_str(), v.length());
+        uint64_t  idx = _variable_bphf->lookup(hash);
+
+        _hashes[idx] = hash;
+        _names[idx] = v;
+        _columns[idx].assign(nrows, get_default_value());
+    }
+
+    _size = variables.size();
+    _rows = nrows;
+}
+
+template<typename T>
+size_t columnstorage<T>::lookup(const uint64_t& hash) const
+{
+    if (_size == 0)
+        return column_handle::npos;
+
+    uint64_t  idx = _variable_bphf->lookup(hash);
+
+    //mphf might return an index, but it isn't actually what we want. double check the hash
+    if( idx >= _size || _hashes[idx] != hash)
+        return column_handle::npos;
+
+    return idx;
+}
+
+template<typename T>
+column_handle columnstorage<T>::resolve(const uint64_t& hash) const
+{
+    size_t idx = lookup(hash);
+    if(idx == column_handle::npos)
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("Variable " + std::to_string(hash) + " does not exist."));
+
+    return column_handle(idx);
+}
+
+template<typename T>
+column_handle columnstorage<T>::resolve(const std::string& variable) const
+{
+    size_t idx = lookup(xxh64::hash (variable.c_str(), variable.length()));
+    if(idx == column_handle::npos)
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("Variable " + variable + " does not exist."));
+
+    return column_handle(idx);
+}
+
+template<typename T>
+bool columnstorage<T>::has(const uint64_t& hash) const
+{
+    return lookup(hash) != column_handle::npos;
+}
+
+template<typename T>
+bool columnstorage<T>::has(const std::string& variable) const
+{
+    return has(xxh64::hash (variable.c_str(), variable.length()));
+}
+
+template<typename T>
+T& columnstorage<T>::at(const uint64_t& hash, size_t row)
+{
+    auto h = resolve(hash);
+    if(row >= _rows)
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("Row " + std::to_string(row) + " is outside of the storage for variable " + _names[h.slot] + "."));
+
+    return _columns[h.slot][row];
+}
+
+template<typename T>
+T& columnstorage<T>::at(const std::string& variable, size_t row)
+{
+    auto h = resolve(variable);
+    if(row >= _rows)
+        BOOST_THROW_EXCEPTION(module_error() << errstr_info("Row " + std::to_string(row) + " is outside of the storage for variable " + variable + "."));
+
+    return _columns[h.slot][row];
+}
+
+template<typename T>
+T* columnstorage<T>::column(const column_handle& h)
+{
+    return _columns.at(h.slot).data();
+}
+
+template<typename T>
+std::vector<std::string> columnstorage<T>::variables() const
+{
+    return _names;
+}
+
+template<typename T>
+const std::string& columnstorage<T>::name(const column_handle& h) const
+{
+    return _names.at(h.slot);
+}
+
+template<typename T>
+size_t columnstorage<T>::size() const
+{
+    return _size;
+}
+
+template<typename T>
+size_t columnstorage<T>::rows() const
+{
+    return _rows;
+}
+
+template<typename T> inline
+T columnstorage<T>::get_default_value() const
+{
+    return T{};
+}
+
+template<> inline
+double columnstorage<double>::get_default_value() const
+{
+    return -9999;
+}
@@ -31,15 +31,26 @@ netcdf::netcdf()
 }
 netcdf::~netcdf()
 {
-
+    // close under the lock rather than in _data's destructor
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
+    try
+    {
+        _data.close();
+    }
+    catch(netCDF::exceptions::NcException& e)
+    {
+        // can't throw from the destructor
+    }
 }
  void netcdf::add_dim1D(const std::string& var, size_t length)
  {
+     std::lock_guard<std::recursive_mutex> lock(library_mutex());
      auto nTri = _data.addDim(var, length);
      _dimVector.push_back(nTri);
  }
 void netcdf::create_variable1D( const std::string& var, size_t length)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     //only create the dim and variables once
     try
     {
@@ -68,8 +79,15 @@ netCDF::NcFile& netcdf::get_ncfile()
     return _data;
 }
 
+std::recursive_mutex& netcdf::library_mutex()
+{
+    static std::recursive_mutex m;
+    return m;
+}
+
 void netcdf::put_var1D(const std::string& var, size_t index, double value)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     auto vars = _data.getVars();
 
     auto itr = vars.find(var);
@@ -93,15 +111,18 @@ void netcdf::put_var1D(const std::string& var, size_t index, double value)
 
 void netcdf::create(const std::string& file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::replace);
 
 }
 void netcdf::open(const std::string &file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::read);
 }
 void netcdf::open_GEM(const std::string &file)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     _data.open(file.c_str(), netCDF::NcFile::read);
 
     //gem netcdf files have 1 coordinate, datetime
@@ -249,6 +270,7 @@ netcdf::data netcdf::get_z()
 
 std::set<std::string> netcdf::get_variable_names()
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     if(_variable_names.empty())
     {
         auto vars = _data.getVars();
@@ -271,6 +293,7 @@ std::set<std::string> netcdf::get_variable_names()
 
 std::set<std::string> netcdf::get_coordinate_names()
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::set<std::string> names;
     auto vars = _data.getCoordVars();
 
@@ -286,6 +309,7 @@ std::set<std::string> netcdf::get_coordinate_names()
 
 double netcdf::get_var1D(std::string var, size_t index)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
     startp.push_back(index);
@@ -303,6 +327,7 @@ double netcdf::get_var1D(std::string var, size_t index)
 
 netcdf::data netcdf::get_var2D(std::string var)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
     startp.push_back(0);
@@ -322,6 +347,7 @@ netcdf::data netcdf::get_var2D(std::string var)
 
 double netcdf::get_var2D(std::string var, size_t x, size_t y)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
 
     startp.push_back(y);
@@ -375,6 +401,7 @@ double netcdf::get_z(size_t x, size_t y)
 
 double netcdf::get_var(std::string var, size_t timestep, size_t x, size_t y)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
     startp.push_back(0);
     startp.push_back(y);
@@ -392,16 +419,14 @@ double netcdf::get_var(std::string var, size_t timestep, size_t x, size_t y)
     double val=-9999;
 
     auto itr = vars.find(var);
-#pragma omp critical
-    {
-        itr->second.getVar(startp, countp, &val);
-    }
+    itr->second.getVar(startp, countp, &val);
 
     return val;
 }
 
 netcdf::data netcdf::get_var(std::string var, size_t timestep)
 {
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
     std::vector<size_t> startp, countp;
     startp.push_back(0);
     startp.push_back(0);
@@ -426,6 +451,33 @@ netcdf::data netcdf::get_var(std::string var, size_t timestep)
      return array;
 }
 
+netcdf::data netcdf::get_var_window(const std::string& var, size_t timestep, size_t x_start, size_t y_start, size_t nx, size_t ny)
+{
+    std::lock_guard<std::recursive_mutex> lock(library_mutex());
+    if( x_start + nx > xgrid || y_start + ny > ygrid)
+    {
+        BOOST_THROW_EXCEPTION(forcing_error() << errstr_info("Requested window for " + var + " is outside of the grid"));
+    }
+
+    std::vector<size_t> startp = {timestep, y_start, x_start};
+    std::vector<size_t> countp = {1, ny, nx};
+
+    netcdf::data array(boost::extents[ny][nx]);
+
+    _data.getVar(var).getVar(startp, countp, array.data());
+
+    return array;
+}
+
+netcdf::data netcdf::get_var_window(const std::string& var, boost::posix_time::ptime timestep, size_t x_start, size_t y_start, size_t nx, size_t ny)
+{
+    auto diff = timestep - _start; // a duration
+
+    auto offset = diff.total_seconds() / _timestep.total_seconds();
+
+    return get_var_window(var, offset, x_start, y_start, nx, ny);
+}
+
 double netcdf::get_var(std::string var, boost::posix_time::ptime timestep, size_t x, size_t y)
 {
     auto diff = timestep - _start; // a duration
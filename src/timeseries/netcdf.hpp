@@ -27,6 +27,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp> // for boost::posix
 #include <netcdf>
+#include <mutex>
 #include <string>
 
 #include "logger.hpp"
@@ -76,6 +77,20 @@ public:
     double get_var(std::string var, size_t timestep, size_t x, size_t y);
     double get_var(std::string var, boost::posix_time::ptime timestep, size_t x, size_t y);
 
+    /**
+     * Reads the window [y_start, y_start + ny) x [x_start, x_start + nx) of var at timestep with a single hyperslab read.
+     * Much faster than calling the scalar get_var per grid cell.
+     * @param var
+     * @param timestep
+     * @param x_start
+     * @param y_start
+     * @param nx
+     * @param ny
+     * @return Array indexed [y - y_start][x - x_start]
+     */
+    data get_var_window(const std::string& var, size_t timestep, size_t x_start, size_t y_start, size_t nx, size_t ny);
+    data get_var_window(const std::string& var, boost::posix_time::ptime timestep, size_t x_start, size_t y_start, size_t nx, size_t ny);
+
     void add_dim1D(const std::string& var, size_t length);
     void create_variable1D(const std::string& var,  size_t length);
     void put_var1D(const std::string& var, size_t index, double value);
@@ -89,7 +104,18 @@ public:
 
     double get_var2D(std::string var, size_t x, size_t y);
 
+    /**
+     * The underlying file. Direct use must hold library_mutex()
+     * @return
+     */
     netCDF::NcFile& get_ncfile();
+
+    /**
+     * netCDF-C and HDF5 are not thread safe, even on different files, so every call into them holds this lock. E.g.,
+     * the forcing prefetch thread reads while the model thread writes a checkpoint.
+     * @return
+     */
+    static std::recursive_mutex& library_mutex();
 private:
 
     netCDF::NcFile _data; // main netcdf file
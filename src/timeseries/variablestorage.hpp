@@ -60,6 +60,25 @@ class variablestorage
     /// @return
     T& operator[](const std::string& variable);
 
+    /// A variable's slot, resolved once so repeated access skips the hashing and lookup.
+    /// Storages initialized with the same variables have the same slots, so a handle can be reused across them.
+    struct handle
+    {
+        size_t idx;
+        uint64_t hash;
+    };
+
+    /// Resolves a variable to a handle.
+    /// Throws if not found or init/ctor not yet called.
+    /// @param variable
+    /// @return
+    handle resolve(const std::string& variable);
+
+    /// Get and set the variable of a handle from resolve. Falls back to the lookup if this storage's slots differ.
+    /// @param h
+    /// @return
+    T& operator[](const handle& h);
+
     /// Determine if a variable is in the storage. Uses _s for compile time hash
     /// @param hash
     /// @return
@@ -82,6 +101,10 @@ class variablestorage
     /// @return
     size_t size();
 
+    /// Exchanges the contents (variables and values) with another storage in O(1)
+    /// @param other
+    void swap(variablestorage<T>& other);
+
   private:
 
     template <typename Item> class wyandFunctor
@@ -173,6 +196,26 @@ T& variablestorage<T>::operator[](const std::string& variable)
     return _variables[idx].value;
 }
 
+template<typename T>
+typename variablestorage<T>::handle variablestorage<T>::resolve(const std::string& variable)
+{
+    (*this)[variable]; // throws if it doesn't exist
+
+    handle h;
+    h.hash = xxh64::hash (variable.c_str(), variable.length());
+    h.idx = _variable_bphf->lookup(h.hash);
+    return h;
+}
+
+template<typename T>
+T& variablestorage<T>::operator[](const handle& h)
+{
+    if (h.idx < _size && _variables[h.idx].xxhash == h.hash)
+        return _variables[h.idx].value;
+
+    return (*this)[h.hash];
+}
+
 template<typename T>
 bool variablestorage<T>::has(const uint64_t& hash)
 {
@@ -252,6 +295,14 @@ size_t variablestorage<T>::size()
     return _size;
 }
 
+template<typename T>
+void variablestorage<T>::swap(variablestorage<T>& other)
+{
+    std::swap(_variable_bphf, other._variable_bphf);
+    std::swap(_variables, other._variables);
+    std::swap(_size, other._size);
+}
+
 template<typename T> inline
 T variablestorage<T>::get_default_value()
 {
@@ -0,0 +1,203 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "profiler.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+
+profiler& profiler::get()
+{
+    static profiler p;
+    return p;
+}
+
+profiler::profiler()
+{
+    _enabled = false;
+    _trace = false;
+    _max_events = 0;
+    _t0 = now();
+}
+
+void profiler::enable(bool trace, size_t max_events)
+{
+    _trace = trace;
+    _max_events = max_events;
+    _t0 = now();
+    _enabled = true;
+}
+
+size_t profiler::region(const std::string& name)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    auto itr = _region_ids.find(name);
+    if(itr != _region_ids.end())
+        return itr->second;
+
+    size_t id = _region_names.size();
+    _region_names.push_back(name);
+    _region_ids[name] = id;
+    return id;
+}
+
+profiler::thread_data& profiler::local()
+{
+    // one per thread per process. As there is only one profiler this is safe to cache.
+    thread_local thread_data* td = nullptr;
+    if(!td)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _threads.emplace_back(new thread_data);
+        td = _threads.back().get();
+        td->tid = _threads.size() - 1;
+        td->dropped = 0;
+    }
+    return *td;
+}
+
+void profiler::record(size_t region, int64_t start, int64_t end, bool trace)
+{
+    auto& td = local();
+    if(region >= td.stats.size())
+        td.stats.resize(region + 1);
+
+    int64_t d = end - start;
+    auto& s = td.stats[region];
+    s.count++;
+    s.total += d;
+    s.min = std::min(s.min, d);
+    s.max = std::max(s.max, d);
+
+    if(_trace && trace)
+    {
+        if(td.events.size() >= _max_events)
+        {
+            td.dropped++;
+            return;
+        }
+
+        event e;
+        e.region = region;
+        e.start = start;
+        e.duration = d;
+        td.events.push_back(e);
+    }
+}
+
+size_t profiler::dropped_events()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    size_t dropped = 0;
+    for(auto& td : _threads)
+        dropped += td->dropped;
+    return dropped;
+}
+
+// minimal escaping for the names we generate
+static std::string json_escape(const std::string& s)
+{
+    std::string out;
+    for(auto c : s)
+    {
+        if(c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+void profiler::write(const std::string& directory, int rank)
+{
+    if(!_enabled)
+        return;
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    std::string suffix = "_" + std::to_string(rank);
+
+    std::ofstream csv(directory + "/profile_summary" + suffix + ".csv");
+    csv << std::fixed << std::setprecision(6);
+    csv << "region,rank,thread,count,total_ms,mean_ms,min_ms,max_ms\n";
+
+    std::ofstream json(directory + "/profile_summary" + suffix + ".json");
+    json << std::fixed << std::setprecision(6);
+    json << "[\n";
+    bool first = true;
+
+    for(auto& td : _threads)
+    {
+        for(size_t r = 0; r < td->stats.size(); ++r)
+        {
+            auto& s = td->stats[r];
+            if(s.count == 0)
+                continue;
+
+            double total = s.total / 1e6;
+            double mean = total / s.count;
+            double min = s.min / 1e6;
+            double max = s.max / 1e6;
+
+            csv << _region_names[r] << "," << rank << "," << td->tid << "," << s.count << ","
+                << total << "," << mean << "," << min << "," << max << "\n";
+
+            if(!first)
+                json << ",\n";
+            first = false;
+            json << "  {\"region\": \"" << json_escape(_region_names[r]) << "\", \"rank\": " << rank
+                 << ", \"thread\": " << td->tid << ", \"count\": " << s.count
+                 << ", \"total_ms\": " << total << ", \"mean_ms\": " << mean
+                 << ", \"min_ms\": " << min << ", \"max_ms\": " << max << "}";
+        }
+    }
+    json << "\n]\n";
+
+    if(!_trace)
+        return;
+
+    // Chrome trace event format, complete events, times in microseconds
+    std::ofstream trace(directory + "/profile_trace" + suffix + ".json");
+    trace << std::fixed << std::setprecision(3);
+    trace << "{\"traceEvents\":[\n";
+    first = true;
+    for(auto& td : _threads)
+    {
+        for(auto& e : td->events)
+        {
+            if(!first)
+                trace << ",\n";
+            first = false;
+            trace << "{\"name\":\"" << json_escape(_region_names[e.region]) << "\",\"ph\":\"X\",\"ts\":"
+                  << (e.start - _t0) / 1e3 << ",\"dur\":" << e.duration / 1e3
+                  << ",\"pid\":" << rank << ",\"tid\":" << td->tid << "}";
+        }
+    }
+    size_t dropped = 0;
+    for(auto& td : _threads)
+        dropped += td->dropped;
+    trace << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+}
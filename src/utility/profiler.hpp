@@ -0,0 +1,192 @@
+//
+// Canadian Hydrological Model - The Canadian Hydrological Model (CHM) is a novel
+// modular unstructured mesh based approach for hydrological modelling
+// Copyright (C) 2018 Christopher Marsh
+//
+// This file is part of Canadian Hydrological Model.
+//
+// Canadian Hydrological Model is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Canadian Hydrological Model is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Canadian Hydrological Model.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <atomic>
+
+#include <boost/preprocessor/cat.hpp>
+
+/**
+ * Lightweight wall-time instrumentation.
+ *
+ * Named regions are registered once and are then timed via profile_scope. Each thread accumulates into its own buffer,
+ * so recording takes no locks. When disabled, a scope costs a single branch.
+ *
+ * Two outputs are produced:
+ *  - a summary (count, total, min, max, mean) per region per thread, as CSV and JSON
+ *  - optionally, a Chrome trace (chrome://tracing or ui.perfetto.dev) of every traced scope
+ *
+ * Scopes around very fine grained work, e.g., a data parallel module's run on one face, should be summary-only so the
+ * trace does not grow with the number of faces.
+ *
+ * Typical use:
+ * @code
+ *   PROFILE_SCOPE("metdata::next");
+ * @endcode
+ */
+class profiler
+{
+  public:
+
+    static profiler& get();
+
+    /**
+     * Enables recording. Until this is called, scopes are no-ops.
+     * @param trace Also record individual events for the Chrome trace
+     * @param max_events Trace events kept per thread. Once reached, further events are counted but dropped so long runs
+     * do not grow the trace without bound
+     */
+    void enable(bool trace, size_t max_events = 1000000);
+
+    inline bool enabled() const
+    {
+        return _enabled;
+    }
+
+    inline bool tracing() const
+    {
+        return _trace;
+    }
+
+    /**
+     * Registers a region and returns its id. Registering the same name returns the same id.
+     * Takes a lock, so obtain the id once and reuse it.
+     * @param name
+     * @return
+     */
+    size_t region(const std::string& name);
+
+    /**
+     * Record a completed region on the calling thread
+     * @param region Region id from region()
+     * @param start Start time, from now()
+     * @param end End time, from now()
+     * @param trace Emit this as a trace event if tracing is enabled
+     */
+    void record(size_t region, int64_t start, int64_t end, bool trace);
+
+    /**
+     * Number of trace events dropped over all threads as the per thread limit was reached
+     * @return
+     */
+    size_t dropped_events();
+
+    /**
+     * Nanoseconds on the monotonic clock
+     * @return
+     */
+    static inline int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Writes profile_summary_<rank>.csv, profile_summary_<rank>.json and, if tracing, profile_trace_<rank>.json
+     * to the given directory. Should be called once all threads have finished recording.
+     * @param directory
+     * @param rank MPI rank, 0 otherwise
+     */
+    void write(const std::string& directory, int rank);
+
+  private:
+    profiler();
+
+    struct stat
+    {
+        stat() : count(0), total(0), min(INT64_MAX), max(0) {}
+        uint64_t count;
+        int64_t total;
+        int64_t min;
+        int64_t max;
+    };
+
+    struct event
+    {
+        size_t region;
+        int64_t start;
+        int64_t duration;
+    };
+
+    // per thread storage, owned by the profiler so it outlives the thread
+    struct thread_data
+    {
+        int tid;
+        std::vector<stat> stats; // indexed by region
+        std::vector<event> events;
+        size_t dropped; // events over _max_events
+    };
+
+    thread_data& local();
+
+    std::atomic<bool> _enabled;
+    bool _trace;
+    size_t _max_events;
+    int64_t _t0; // time enable() was called, trace timestamps are relative to this
+
+    std::mutex _lock;
+    std::map<std::string, size_t> _region_ids;
+    std::vector<std::string> _region_names;
+    std::vector< std::unique_ptr<thread_data> > _threads;
+};
+
+/**
+ * RAII timer for a region
+ */
+class profile_scope
+{
+  public:
+    inline profile_scope(size_t region, bool trace = true)
+    {
+        _region = region;
+        _trace = trace;
+        _active = profiler::get().enabled();
+        if(_active)
+            _start = profiler::now();
+    }
+
+    inline ~profile_scope()
+    {
+        if(_active)
+            profiler::get().record(_region, _start, profiler::now(), _trace);
+    }
+
+  private:
+    size_t _region;
+    int64_t _start;
+    bool _trace;
+    bool _active;
+};
+
+// Times the rest of the enclosing scope under a fixed name. The region id is resolved once per call site.
+#define PROFILE_SCOPE(name) \
+    static const size_t BOOST_PP_CAT(_profile_region_, __LINE__) = profiler::get().region(name); \
+    profile_scope BOOST_PP_CAT(_profile_scope_, __LINE__)(BOOST_PP_CAT(_profile_region_, __LINE__))